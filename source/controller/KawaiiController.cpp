@@ -1,15 +1,19 @@
 /**
- * KawaiiController.cpp — K50V: Register 32-partial + filter params
+ * KawaiiController.cpp — K50V: Register partial (up to 128) + filter params
  */
 
 #include "KawaiiController.h"
 #include "../entry/KawaiiCids.h"
 #include "../params/KawaiiParams.h"
 #include "../params/KawaiiFilterTypes.h"
+#include "../params/KawaiiModMatrix.h"
 #include "../editor/KawaiiEditor.h"
 #include "pluginterfaces/base/ibstream.h"
 #include "pluginterfaces/base/ustring.h"
 #include "pluginterfaces/vst/ivsteditcontroller.h"
+#include "pluginterfaces/vst/ivstmidicontrollers.h"
+
+#include <array>
 
 namespace Steinberg {
 namespace Vst {
@@ -29,10 +33,44 @@ tresult PLUGIN_API KawaiiController::initialize(FUnknown* context)
     parameters.addParameter(STR16("Master Volume"), STR16("%"), 0, 0.7,
         ParameterInfo::kCanAutomate, kParamMasterVolume, 0, STR16("Master"));
 
-    parameters.addParameter(STR16("Master Tune"), STR16("cents"), 0, 0.5,
-        ParameterInfo::kCanAutomate, kParamMasterTune, 0, STR16("Master"));
+    // Master Tune — ±100 cents around A4 = 440 Hz (normalized 0.5 = 0)
+    parameters.addParameter(new RangeParameter(
+        STR16("Master Tune"), kParamMasterTune, STR16("cents"),
+        -ParamRanges::kMasterTuneCents, ParamRanges::kMasterTuneCents, 0.0,
+        0, ParameterInfo::kCanAutomate, 0, STR16("Master")));
+
+    // --- Pitch ---
+
+    // Pitch Bend — hosts route MIDI pitch bend here (getMidiControllerAssignment)
+    parameters.addParameter(STR16("Pitch Bend"), STR16("%"), 0, 0.5,
+        ParameterInfo::kCanAutomate, kParamPitchBend, 0, STR16("Pitch"));
+
+    parameters.addParameter(new RangeParameter(
+        STR16("Pitch Bend Range"), kParamPitchBendRange, STR16("st"),
+        0.0, ParamRanges::kPitchBendRangeMax, ParamRanges::kPitchBendRangeDefault,
+        static_cast<int32>(ParamRanges::kPitchBendRangeMax), ParameterInfo::kCanAutomate));
+
+    // Tuning table — the pitch each MIDI note plays, 12-TET by default.
+    // The plugin has no tuning UI or file loader: a table only arrives with
+    // a saved state (e.g. a preset written from a Scala file by tools built
+    // on KawaiiTuning.h). Hidden so the 128 entries stay out of hosts'
+    // generic parameter lists, and not automatable; a change applies from
+    // the note's next note-on.
+    for (int n = 0; n < kNumMidiNotes; n++)
+    {
+        char tempName[32];
+        char16 name[32];
+        snprintf(tempName, sizeof(tempName), "Note %d Pitch", n);
+        for (int j = 0; j <= (int)strlen(tempName); j++)
+            name[j] = static_cast<char16>(tempName[j]);
+        parameters.addParameter(new RangeParameter(
+            name, tuningParam(n), STR16("st"),
+            ParamRanges::kTuningPitchMin, ParamRanges::kTuningPitchMin + ParamRanges::kTuningPitchSpan,
+            static_cast<double>(n), 0, ParameterInfo::kIsHidden));
+    }
 
-    // --- Per-partial: Level + ADSR (32 partials x 5 params = 160 params) ---
+    // --- Per-partial: Level + ADSR (128 partials x 5 params = 640 params) ---
+    // Partials beyond the active Partial Count are registered but unused.
 
     for (int i = 0; i < kMaxPartials; i++)
     {
@@ -135,6 +173,166 @@ tresult PLUGIN_API KawaiiController::initialize(FUnknown* context)
     subTypeParam->appendString(STR16("Sub 4"));
     parameters.addParameter(subTypeParam);
 
+    // Filter Oversampling — runs only the filter at 2×/4× the host rate
+    auto* oversampleParam = new StringListParameter(
+        STR16("Filter Oversampling"), kParamFilterOversample, nullptr,
+        ParameterInfo::kCanAutomate | ParameterInfo::kIsList);
+    oversampleParam->appendString(STR16("Off"));
+    oversampleParam->appendString(STR16("2x"));
+    oversampleParam->appendString(STR16("4x"));
+    parameters.addParameter(oversampleParam);
+
+    // Filter Mode — Spectral folds linear SVF types into the partial gains
+    // (KAWAII_NATIVE_SVF builds; otherwise it renders in the time domain)
+    auto* spectralParam = new StringListParameter(
+        STR16("Filter Mode"), kParamFilterSpectral, nullptr,
+        ParameterInfo::kCanAutomate | ParameterInfo::kIsList);
+    spectralParam->appendString(STR16("Time Domain"));
+    spectralParam->appendString(STR16("Spectral"));
+    parameters.addParameter(spectralParam);
+
+    // Partial Rendering — Multi-Rate synthesizes low partials at half rate
+    auto* renderingParam = new StringListParameter(
+        STR16("Partial Rendering"), kParamPartialRendering, nullptr,
+        ParameterInfo::kCanAutomate | ParameterInfo::kIsList);
+    renderingParam->appendString(STR16("Full Rate"));
+    renderingParam->appendString(STR16("Multi-Rate"));
+    parameters.addParameter(renderingParam);
+
+    // Quality — Auto lets the CPU governor pick a tier; the rest pin one
+    auto* qualityParam = new StringListParameter(
+        STR16("Quality"), kParamQuality, nullptr,
+        ParameterInfo::kCanAutomate | ParameterInfo::kIsList);
+    qualityParam->appendString(STR16("Auto"));
+    qualityParam->appendString(STR16("Full"));
+    qualityParam->appendString(STR16("Cull Partials"));
+    qualityParam->appendString(STR16("Fast Sine"));
+    qualityParam->appendString(STR16("No Filter Oversampling"));
+    qualityParam->appendString(STR16("Shed Voices"));
+    parameters.addParameter(qualityParam);
+
+    // Render Backend — which path the processor picked; its latency differs
+    auto* backendParam = new StringListParameter(
+        STR16("Render Backend"), kParamRenderBackend, nullptr,
+        ParameterInfo::kIsReadOnly | ParameterInfo::kIsList);
+    backendParam->appendString(STR16("Inline CPU"));
+    backendParam->appendString(STR16("Offload"));
+    parameters.addParameter(backendParam);
+
+    // Memory Footprint — bytes this instance holds, reported at activation
+    parameters.addParameter(new RangeParameter(
+        STR16("Memory Footprint"), kParamMemoryFootprint, STR16("MB"),
+        0.0, kMemoryFootprintMaxMB, 0.0, 0, ParameterInfo::kIsReadOnly));
+
+    // Partial Count — discrete list; the processor picks it up on activation.
+    // Engine Partial Count is the processor's answer: the count it runs, or
+    // the one it needs next, whose change restarts the component
+    // (setParamNormalized)
+    auto* partialCountParam = new StringListParameter(
+        STR16("Partial Count"), kParamPartialCount, nullptr, ParameterInfo::kIsList);
+    auto* engineCountParam = new StringListParameter(
+        STR16("Engine Partial Count"), kParamEnginePartialCount, nullptr,
+        ParameterInfo::kIsReadOnly | ParameterInfo::kIsList);
+    for (int i = 0; i < kNumPartialCountOptions; i++)
+    {
+        char tempName[8];
+        char16 name[8];
+        snprintf(tempName, sizeof(tempName), "%d", kPartialCountOptions[i]);
+        for (int j = 0; j <= (int)strlen(tempName); j++)
+            name[j] = static_cast<char16>(tempName[j]);
+        partialCountParam->appendString(name);
+        engineCountParam->appendString(name);
+    }
+    double defaultCount = static_cast<double>(kDefaultPartialCountIndex) / (kNumPartialCountOptions - 1);
+    for (auto* param : { partialCountParam, engineCountParam })
+    {
+        param->getInfo().defaultNormalizedValue = defaultCount;
+        param->setNormalized(defaultCount);
+        parameters.addParameter(param);
+    }
+
+    // --- Modulation: mod wheel, 2 LFOs, 4 matrix slots ---
+
+    // Mod Wheel — hosts route MIDI CC 1 here (getMidiControllerAssignment)
+    parameters.addParameter(STR16("Mod Wheel"), STR16("%"), 0, 0.0,
+        ParameterInfo::kCanAutomate, kParamModWheel, 0, STR16("Mod"));
+
+    // LFO 1 restarts with each voice; LFO 2 runs free, shared by all voices
+    static constexpr ParamID kLfoRate[]  = { kParamLfo1Rate, kParamLfo2Rate };
+    static constexpr ParamID kLfoShape[] = { kParamLfo1Shape, kParamLfo2Shape };
+    for (int l = 0; l < 2; l++)
+    {
+        char tempName[32];
+        char16 name[32];
+
+        // Rate (normalized 0–1, exponential mapping 0.02–20 Hz in processor)
+        snprintf(tempName, sizeof(tempName), "LFO %d Rate", l + 1);
+        for (int j = 0; j <= (int)strlen(tempName); j++)
+            name[j] = static_cast<char16>(tempName[j]);
+        parameters.addParameter(name, STR16("Hz"), 0, kLfoRateDefault,
+            ParameterInfo::kCanAutomate, kLfoRate[l], 0, STR16("Mod"));
+
+        snprintf(tempName, sizeof(tempName), "LFO %d Shape", l + 1);
+        for (int j = 0; j <= (int)strlen(tempName); j++)
+            name[j] = static_cast<char16>(tempName[j]);
+        auto* shapeParam = new StringListParameter(
+            name, kLfoShape[l], nullptr, ParameterInfo::kCanAutomate | ParameterInfo::kIsList);
+        for (int i = 0; i < kNumLfoShapes; i++)
+        {
+            const char* shapeName = lfoShapeName(i);
+            char16 wide[16];
+            for (int j = 0; j <= (int)strlen(shapeName); j++)
+                wide[j] = static_cast<char16>(shapeName[j]);
+            shapeParam->appendString(wide);
+        }
+        parameters.addParameter(shapeParam);
+    }
+
+    // Mod slots — Source → Destination by a bipolar Amount (0 = none)
+    for (int slot = 0; slot < kNumModSlots; slot++)
+    {
+        char tempName[32];
+        char16 name[32];
+        char16 wide[32];
+
+        snprintf(tempName, sizeof(tempName), "Mod %d Source", slot + 1);
+        for (int j = 0; j <= (int)strlen(tempName); j++)
+            name[j] = static_cast<char16>(tempName[j]);
+        auto* sourceParam = new StringListParameter(
+            name, modSlotParam(slot, kModSlotOffSource), nullptr,
+            ParameterInfo::kCanAutomate | ParameterInfo::kIsList);
+        for (int i = 0; i < kNumModSources; i++)
+        {
+            const char* sourceName = modSourceName(i);
+            for (int j = 0; j <= (int)strlen(sourceName); j++)
+                wide[j] = static_cast<char16>(sourceName[j]);
+            sourceParam->appendString(wide);
+        }
+        parameters.addParameter(sourceParam);
+
+        snprintf(tempName, sizeof(tempName), "Mod %d Destination", slot + 1);
+        for (int j = 0; j <= (int)strlen(tempName); j++)
+            name[j] = static_cast<char16>(tempName[j]);
+        auto* destParam = new StringListParameter(
+            name, modSlotParam(slot, kModSlotOffDest), nullptr,
+            ParameterInfo::kCanAutomate | ParameterInfo::kIsList);
+        for (int i = 0; i < kNumModDestinations; i++)
+        {
+            const char* destName = modDestinationName(i);
+            for (int j = 0; j <= (int)strlen(destName); j++)
+                wide[j] = static_cast<char16>(destName[j]);
+            destParam->appendString(wide);
+        }
+        parameters.addParameter(destParam);
+
+        snprintf(tempName, sizeof(tempName), "Mod %d Amount", slot + 1);
+        for (int j = 0; j <= (int)strlen(tempName); j++)
+            name[j] = static_cast<char16>(tempName[j]);
+        parameters.addParameter(new RangeParameter(
+            name, modSlotParam(slot, kModSlotOffAmount), STR16("%"),
+            -100.0, 100.0, 0.0, 0, ParameterInfo::kCanAutomate, 0, STR16("Mod")));
+    }
+
     return kResultOk;
 }
 
@@ -149,17 +347,84 @@ tresult PLUGIN_API KawaiiController::setComponentState(IBStream* state)
     if (!state)
         return kResultFalse;
 
+    // Read over the defaults, like KawaiiProcessor::setState: older states
+    // end before the appended params, which must return to their defaults
+    // rather than keep the previous patch's values
+    std::array<ParamValue, kNumParams> loaded;
+    for (int32 i = 0; i < kNumParams; i++)
+    {
+        Parameter* param = getParameterObject(i);
+        loaded[(size_t)i] = param ? param->getInfo().defaultNormalizedValue : 0.0;
+    }
+
+    int32 numRead = 0;
     for (int32 i = 0; i < kNumParams; i++)
     {
         float value;
-        int32 numBytesRead;
+        int32 numBytesRead = 0;
         if (state->read(&value, sizeof(float), &numBytesRead) != kResultOk)
             return kResultFalse;
-        setParamNormalized(i, value);
+        if (numBytesRead != sizeof(float))
+            break;
+        loaded[(size_t)i] = value;
+        numRead++;
+    }
+
+    // Same fix-up as KawaiiProcessor::setState: Master Tune was inert
+    // before the pitch params existed
+    if (numRead <= kParamPitchBend)
+        loaded[kParamMasterTune] = 0.5;
+
+    for (int32 i = 0; i < kNumParams; i++)
+    {
+        if (i == kParamRenderBackend || i == kParamMemoryFootprint || i == kParamEnginePartialCount)
+            continue;   // reported live by the processor, not restored
+        setParamNormalized(i, loaded[(size_t)i]);
     }
     return kResultOk;
 }
 
+// MIDI pitch bend and the mod wheel (CC 1), any channel
+tresult PLUGIN_API KawaiiController::getMidiControllerAssignment(int32 busIndex, int16 /*channel*/,
+                                                                 CtrlNumber midiControllerNumber, ParamID& id)
+{
+    if (busIndex != 0)
+        return kResultFalse;
+    if (midiControllerNumber == kPitchBend)
+    {
+        id = kParamPitchBend;
+        return kResultTrue;
+    }
+    if (midiControllerNumber == kCtrlModWheel)
+    {
+        id = kParamModWheel;
+        return kResultTrue;
+    }
+    return kResultFalse;
+}
+
+// The processor reports a render path switch through kParamRenderBackend
+// (offload adds a block of latency, so the host must re-query it) and a
+// new partial count through kParamEnginePartialCount
+tresult PLUGIN_API KawaiiController::setParamNormalized(ParamID tag, ParamValue value)
+{
+    // Both are only applied in the processor's setActive(): a restart makes
+    // the host deactivate and reactivate it (and re-query the latency). The
+    // processor sends them once it holds the new value itself, so the
+    // restart cannot overtake it.
+    bool needsRestart = (tag == kParamRenderBackend || tag == kParamEnginePartialCount)
+                        && value != getParamNormalized(tag);
+
+    bool countChanged = tag == kParamPartialCount && value != getParamNormalized(tag);
+
+    tresult result = EditController::setParamNormalized(tag, value);
+    if (result == kResultOk && needsRestart && componentHandler)
+        componentHandler->restartComponent(kLatencyChanged);
+    if (result == kResultOk && countChanged && openEditor)
+        openEditor->partialCountChanged();
+    return result;
+}
+
 tresult PLUGIN_API KawaiiController::setState(IBStream* state)
 {
     return setComponentState(state);
@@ -187,6 +452,17 @@ IPlugView* PLUGIN_API KawaiiController::createView(FIDString name)
     return nullptr;
 }
 
+void KawaiiController::editorAttached(EditorView* editor)
+{
+    openEditor = dynamic_cast<KawaiiEditor*>(editor);
+}
+
+void KawaiiController::editorRemoved(EditorView* editor)
+{
+    if (editor == openEditor)
+        openEditor = nullptr;
+}
+
 } // namespace Kawaii
 } // namespace Vst
 } // namespace Steinberg
@@ -26,13 +26,16 @@
 #pragma once
 
 #include "public.sdk/source/vst/vsteditcontroller.h"  // Base class for controllers
+#include "pluginterfaces/vst/ivsteditcontroller.h"     // IMidiMapping
 #include "../entry/KawaiiCids.h"                       // Parameter IDs
 
 namespace Steinberg {
 namespace Vst {
 namespace Kawaii {
 
-class KawaiiController : public EditController
+class KawaiiEditor;
+
+class KawaiiController : public EditController, public IMidiMapping
 {
 public:
     KawaiiController();
@@ -69,12 +72,42 @@ public:
     tresult PLUGIN_API setState(IBStream* state) override;
     tresult PLUGIN_API getState(IBStream* state) override;
 
+    /**
+     * Host-facing parameter updates, including the processor's output
+     * parameters. A change of kParamRenderBackend means the plugin's latency
+     * changed, and one of kParamEnginePartialCount that the processor needs
+     * a new voice bank; either asks the host to restart the component
+     * (kLatencyChanged).
+     */
+    tresult PLUGIN_API setParamNormalized(ParamID tag, ParamValue value) override;
+
     /**
      * Called when the DAW wants to show the plugin's UI window.
      * Returns nullptr for Phase 1 — the DAW will show its own generic
      * parameter editor (basic sliders). Custom UI comes in Phase 8.
      */
     IPlugView* PLUGIN_API createView(FIDString name) override;
+
+    // The open editor, told about Partial Count changes so its grid follows
+    void editorAttached(EditorView* editor) override;
+    void editorRemoved(EditorView* editor) override;
+
+    /**
+     * MIDI controller → parameter mapping. VST3 has no pitch-bend event:
+     * the host turns MIDI pitch bend into changes of the parameter named
+     * here (kParamPitchBend), and CC 1 into the Mod Wheel (kParamModWheel).
+     */
+    tresult PLUGIN_API getMidiControllerAssignment(int32 busIndex, int16 channel,
+                                                   CtrlNumber midiControllerNumber, ParamID& id) override;
+
+    OBJ_METHODS(KawaiiController, EditController)
+    DEFINE_INTERFACES
+        DEF_INTERFACE(IMidiMapping)
+    END_DEFINE_INTERFACES(EditController)
+    REFCOUNT_METHODS(EditController)
+
+private:
+    KawaiiEditor* openEditor = nullptr;
 };
 
 } // namespace Kawaii
@@ -0,0 +1,467 @@
+/**
+ * RealtimeSanitizer.cpp — Interposers + violation recorder for KAWAII_RT_SANITIZER
+ *
+ * Built as its own shared library (kawaii_rtsan) so the interposers can be
+ * loaded at launch. Everything on the hook path is allocation-free:
+ *   - per-thread state lives in a pthread key (macOS thread_local storage is
+ *     allocated lazily with malloc, which would recurse into the hook)
+ *   - records go into a fixed array claimed with an atomic counter
+ *   - a per-thread "in hook" bit lets backtrace()'s own allocations through
+ *
+ * macOS: dyld __interpose tuples; the replacements call the real functions
+ *        directly (dyld never interposes calls made from the interposing image).
+ * glibc: the symbols are defined here and forward to __libc_* / RTLD_NEXT.
+ *        Only calls that cross into libc are seen: sleep() and fopen() are
+ *        hooked themselves, since libc reaches nanosleep/open internally.
+ */
+
+#ifndef __APPLE__
+#undef _FORTIFY_SOURCE   // its inline open() wrappers clash with the definitions below
+#endif
+
+#include "RealtimeSanitizer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdarg>
+#include <cerrno>
+#include <cstdint>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+
+#ifdef __APPLE__
+#include <os/lock.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+namespace RtSan {
+
+namespace {
+
+enum Kind
+{
+    kMalloc, kCalloc, kRealloc, kFree, kAlignedAlloc,
+    kMutexLock, kRwLock, kCondWait, kUnfairLock,
+    kSleep, kOpen, kRead, kWrite,
+    kNumKinds
+};
+
+const char* const kKindNames[kNumKinds] = {
+    "malloc", "calloc", "realloc", "free", "posix_memalign/aligned_alloc",
+    "pthread_mutex_lock", "pthread_rwlock_*lock", "pthread_cond_*wait", "os_unfair_lock_lock",
+    "sleep/usleep/nanosleep", "open/fopen", "read", "write",
+};
+
+constexpr int kMaxFrames  = 32;
+constexpr int kMaxRecords = 512;
+
+struct Record
+{
+    int   kind;
+    int   numFrames;
+    void* frames[kMaxFrames];
+};
+
+Record records[kMaxRecords];
+std::atomic<int> recordSlots{0};
+std::atomic<int> totalViolations{0};
+std::atomic<int> kindCounts[kNumKinds];
+
+// Per-thread state packed into the key's value: (depth << 1) | inHook
+pthread_key_t stateKey;
+std::atomic<bool> keyReady{false};
+
+inline uintptr_t loadState()
+{
+    if (!keyReady.load(std::memory_order_acquire))
+        return 0;
+    return reinterpret_cast<uintptr_t>(pthread_getspecific(stateKey));
+}
+
+inline void storeState(uintptr_t s)
+{
+    pthread_setspecific(stateKey, reinterpret_cast<void*>(s));
+}
+
+void recordViolation(Kind kind)
+{
+    uintptr_t state = loadState();
+    if ((state >> 1) == 0 || (state & 1))
+        return;  // not realtime, or already inside a hook
+
+    storeState(state | 1);
+
+    totalViolations.fetch_add(1, std::memory_order_relaxed);
+    kindCounts[kind].fetch_add(1, std::memory_order_relaxed);
+
+    int slot = recordSlots.fetch_add(1, std::memory_order_relaxed);
+    if (slot < kMaxRecords)
+    {
+        Record& r = records[slot];
+        r.kind = kind;
+        r.numFrames = backtrace(r.frames, kMaxFrames);
+    }
+
+    storeState(state);
+}
+
+void writeReportAtExit()
+{
+    writeReport(nullptr);
+}
+
+__attribute__((constructor)) void initSanitizer()
+{
+    if (pthread_key_create(&stateKey, nullptr) == 0)
+        keyReady.store(true, std::memory_order_release);
+
+    // Warm up backtrace() outside any realtime scope — the first call may
+    // load the unwinder and allocate.
+    void* frames[4];
+    backtrace(frames, 4);
+
+    atexit(writeReportAtExit);
+}
+
+} // namespace
+
+void enterRealtime()
+{
+    if (!keyReady.load(std::memory_order_acquire))
+        return;
+    uintptr_t s = loadState();
+    storeState(s + 2);
+}
+
+void exitRealtime()
+{
+    if (!keyReady.load(std::memory_order_acquire))
+        return;
+    uintptr_t s = loadState();
+    if (s >= 2)
+        storeState(s - 2);
+}
+
+int violationCount()
+{
+    return totalViolations.load(std::memory_order_relaxed);
+}
+
+bool writeReport(const char* path)
+{
+    if (!path)
+        path = getenv("KAWAII_RTSAN_REPORT");
+    if (!path || !*path)
+        path = "kawaii_rtsan_report.txt";
+
+    FILE* f = fopen(path, "w");
+    if (!f)
+        return false;
+
+    int total = totalViolations.load();
+    int stored = std::min(recordSlots.load(), kMaxRecords);
+
+    fprintf(f, "Kawaii realtime sanitizer report\n");
+    fprintf(f, "================================\n\n");
+    fprintf(f, "Violations inside realtime scope: %d (%d with stack traces)\n\n", total, stored);
+
+    for (int k = 0; k < kNumKinds; k++)
+    {
+        int n = kindCounts[k].load();
+        if (n > 0)
+            fprintf(f, "  %-32s %d\n", kKindNames[k], n);
+    }
+
+    // backtrace_symbols_fd writes straight to the descriptor (no malloc)
+    fflush(f);
+    int fd = fileno(f);
+    for (int i = 0; i < stored; i++)
+    {
+        const Record& r = records[i];
+        fprintf(f, "\n#%d  %s\n", i, kKindNames[r.kind]);
+        fflush(f);
+        backtrace_symbols_fd(r.frames, r.numFrames, fd);
+    }
+
+    fclose(f);
+    return true;
+}
+
+} // namespace RtSan
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
+
+// ============================================================================
+// Interposers
+// ============================================================================
+
+using namespace Steinberg::Vst::Kawaii::RtSan;
+
+#ifdef __APPLE__
+
+#define KAWAII_INTERPOSE(replacement, replacee)                                  \
+    __attribute__((used)) static const struct {                                  \
+        const void* r; const void* e;                                             \
+    } interpose_##replacee __attribute__((section("__DATA,__interpose"))) = {   \
+        reinterpret_cast<const void*>(&replacement),                              \
+        reinterpret_cast<const void*>(&replacee)                                  \
+    };
+
+extern "C" {
+
+static void* rtsan_malloc(size_t n)            { recordViolation(kMalloc);  return malloc(n); }
+static void* rtsan_calloc(size_t c, size_t n)  { recordViolation(kCalloc);  return calloc(c, n); }
+static void* rtsan_realloc(void* p, size_t n)  { recordViolation(kRealloc); return realloc(p, n); }
+static void  rtsan_free(void* p)               { if (p) recordViolation(kFree); free(p); }
+static int   rtsan_posix_memalign(void** p, size_t a, size_t n) { recordViolation(kAlignedAlloc); return posix_memalign(p, a, n); }
+
+static int rtsan_pthread_mutex_lock(pthread_mutex_t* m)        { recordViolation(kMutexLock); return pthread_mutex_lock(m); }
+static int rtsan_pthread_rwlock_rdlock(pthread_rwlock_t* l)    { recordViolation(kRwLock);    return pthread_rwlock_rdlock(l); }
+static int rtsan_pthread_rwlock_wrlock(pthread_rwlock_t* l)    { recordViolation(kRwLock);    return pthread_rwlock_wrlock(l); }
+static int rtsan_pthread_cond_wait(pthread_cond_t* c, pthread_mutex_t* m) { recordViolation(kCondWait); return pthread_cond_wait(c, m); }
+static int rtsan_pthread_cond_timedwait(pthread_cond_t* c, pthread_mutex_t* m, const struct timespec* t)
+{
+    recordViolation(kCondWait);
+    return pthread_cond_timedwait(c, m, t);
+}
+static void rtsan_os_unfair_lock_lock(os_unfair_lock_t l)      { recordViolation(kUnfairLock); os_unfair_lock_lock(l); }
+
+static unsigned rtsan_sleep(unsigned s)                        { recordViolation(kSleep); return sleep(s); }
+static int rtsan_usleep(useconds_t us)                         { recordViolation(kSleep); return usleep(us); }
+static int rtsan_nanosleep(const struct timespec* a, struct timespec* b) { recordViolation(kSleep); return nanosleep(a, b); }
+
+static int rtsan_open(const char* path, int flags, ...)
+{
+    recordViolation(kOpen);
+    mode_t mode = 0;
+    if (flags & O_CREAT)
+    {
+        va_list ap;
+        va_start(ap, flags);
+        mode = static_cast<mode_t>(va_arg(ap, int));
+        va_end(ap);
+    }
+    return open(path, flags, mode);
+}
+static FILE* rtsan_fopen(const char* path, const char* mode)   { recordViolation(kOpen);  return fopen(path, mode); }
+static ssize_t rtsan_read(int fd, void* b, size_t n)           { recordViolation(kRead);  return read(fd, b, n); }
+static ssize_t rtsan_write(int fd, const void* b, size_t n)    { recordViolation(kWrite); return write(fd, b, n); }
+
+} // extern "C"
+
+KAWAII_INTERPOSE(rtsan_malloc, malloc)
+KAWAII_INTERPOSE(rtsan_calloc, calloc)
+KAWAII_INTERPOSE(rtsan_realloc, realloc)
+KAWAII_INTERPOSE(rtsan_free, free)
+KAWAII_INTERPOSE(rtsan_posix_memalign, posix_memalign)
+KAWAII_INTERPOSE(rtsan_pthread_mutex_lock, pthread_mutex_lock)
+KAWAII_INTERPOSE(rtsan_pthread_rwlock_rdlock, pthread_rwlock_rdlock)
+KAWAII_INTERPOSE(rtsan_pthread_rwlock_wrlock, pthread_rwlock_wrlock)
+KAWAII_INTERPOSE(rtsan_pthread_cond_wait, pthread_cond_wait)
+KAWAII_INTERPOSE(rtsan_pthread_cond_timedwait, pthread_cond_timedwait)
+KAWAII_INTERPOSE(rtsan_os_unfair_lock_lock, os_unfair_lock_lock)
+KAWAII_INTERPOSE(rtsan_sleep, sleep)
+KAWAII_INTERPOSE(rtsan_usleep, usleep)
+KAWAII_INTERPOSE(rtsan_nanosleep, nanosleep)
+KAWAII_INTERPOSE(rtsan_open, open)
+KAWAII_INTERPOSE(rtsan_fopen, fopen)
+KAWAII_INTERPOSE(rtsan_read, read)
+KAWAII_INTERPOSE(rtsan_write, write)
+
+#else // glibc
+
+// Resolved lazily; glibc's own dlsym locking does not go through these symbols
+template <typename Fn>
+static Fn realFn(Fn& cache, const char* name)
+{
+    if (!cache)
+        cache = reinterpret_cast<Fn>(dlsym(RTLD_NEXT, name));
+    return cache;
+}
+
+extern "C" {
+
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+void  __libc_free(void*);
+void* __libc_memalign(size_t, size_t);
+
+void* malloc(size_t n)           { recordViolation(kMalloc);  return __libc_malloc(n); }
+void* calloc(size_t c, size_t n) { recordViolation(kCalloc);  return __libc_calloc(c, n); }
+void* realloc(void* p, size_t n) { recordViolation(kRealloc); return __libc_realloc(p, n); }
+void  free(void* p)              { if (p) recordViolation(kFree); __libc_free(p); }
+
+static bool isPowerOfTwo(size_t a) { return a != 0 && (a & (a - 1)) == 0; }
+
+int posix_memalign(void** p, size_t a, size_t n)
+{
+    recordViolation(kAlignedAlloc);
+    if (!isPowerOfTwo(a) || a % sizeof(void*) != 0)
+        return EINVAL;
+    void* mem = __libc_memalign(a, n);
+    if (!mem)
+        return ENOMEM;
+    *p = mem;
+    return 0;
+}
+
+void* aligned_alloc(size_t a, size_t n)
+{
+    recordViolation(kAlignedAlloc);
+    if (!isPowerOfTwo(a))
+    {
+        errno = EINVAL;
+        return nullptr;
+    }
+    return __libc_memalign(a, n);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* m)
+{
+    static int (*real)(pthread_mutex_t*) = nullptr;
+    recordViolation(kMutexLock);
+    return realFn(real, "pthread_mutex_lock")(m);
+}
+
+int pthread_rwlock_rdlock(pthread_rwlock_t* l)
+{
+    static int (*real)(pthread_rwlock_t*) = nullptr;
+    recordViolation(kRwLock);
+    return realFn(real, "pthread_rwlock_rdlock")(l);
+}
+
+int pthread_rwlock_wrlock(pthread_rwlock_t* l)
+{
+    static int (*real)(pthread_rwlock_t*) = nullptr;
+    recordViolation(kRwLock);
+    return realFn(real, "pthread_rwlock_wrlock")(l);
+}
+
+int pthread_cond_wait(pthread_cond_t* c, pthread_mutex_t* m)
+{
+    static int (*real)(pthread_cond_t*, pthread_mutex_t*) = nullptr;
+    recordViolation(kCondWait);
+    return realFn(real, "pthread_cond_wait")(c, m);
+}
+
+int pthread_cond_timedwait(pthread_cond_t* c, pthread_mutex_t* m, const struct timespec* t)
+{
+    static int (*real)(pthread_cond_t*, pthread_mutex_t*, const struct timespec*) = nullptr;
+    recordViolation(kCondWait);
+    return realFn(real, "pthread_cond_timedwait")(c, m, t);
+}
+
+unsigned sleep(unsigned s)
+{
+    static unsigned (*real)(unsigned) = nullptr;
+    recordViolation(kSleep);
+    return realFn(real, "sleep")(s);
+}
+
+int nanosleep(const struct timespec* a, struct timespec* b)
+{
+    static int (*real)(const struct timespec*, struct timespec*) = nullptr;
+    recordViolation(kSleep);
+    return realFn(real, "nanosleep")(a, b);
+}
+
+int usleep(useconds_t us)
+{
+    static int (*real)(useconds_t) = nullptr;
+    recordViolation(kSleep);
+    return realFn(real, "usleep")(us);
+}
+
+int clock_nanosleep(clockid_t clock, int flags, const struct timespec* a, struct timespec* b)
+{
+    static int (*real)(clockid_t, int, const struct timespec*, struct timespec*) = nullptr;
+    recordViolation(kSleep);
+    return realFn(real, "clock_nanosleep")(clock, flags, a, b);
+}
+
+// The mode argument is only there with O_CREAT or O_TMPFILE
+static mode_t openMode(int flags, va_list ap)
+{
+    bool needsMode = (flags & O_CREAT) != 0;
+#ifdef O_TMPFILE
+    needsMode = needsMode || (flags & O_TMPFILE) == O_TMPFILE;
+#endif
+    return needsMode ? static_cast<mode_t>(va_arg(ap, int)) : 0;
+}
+
+int open(const char* path, int flags, ...)
+{
+    static int (*real)(const char*, int, ...) = nullptr;
+    recordViolation(kOpen);
+    va_list ap;
+    va_start(ap, flags);
+    mode_t mode = openMode(flags, ap);
+    va_end(ap);
+    return realFn(real, "open")(path, flags, mode);
+}
+
+int open64(const char* path, int flags, ...)
+{
+    static int (*real)(const char*, int, ...) = nullptr;
+    recordViolation(kOpen);
+    va_list ap;
+    va_start(ap, flags);
+    mode_t mode = openMode(flags, ap);
+    va_end(ap);
+    return realFn(real, "open64")(path, flags, mode);
+}
+
+int openat(int dirfd, const char* path, int flags, ...)
+{
+    static int (*real)(int, const char*, int, ...) = nullptr;
+    recordViolation(kOpen);
+    va_list ap;
+    va_start(ap, flags);
+    mode_t mode = openMode(flags, ap);
+    va_end(ap);
+    return realFn(real, "openat")(dirfd, path, flags, mode);
+}
+
+FILE* fopen(const char* path, const char* mode)
+{
+    static FILE* (*real)(const char*, const char*) = nullptr;
+    recordViolation(kOpen);
+    return realFn(real, "fopen")(path, mode);
+}
+
+FILE* fopen64(const char* path, const char* mode)
+{
+    static FILE* (*real)(const char*, const char*) = nullptr;
+    recordViolation(kOpen);
+    return realFn(real, "fopen64")(path, mode);
+}
+
+ssize_t read(int fd, void* b, size_t n)
+{
+    static ssize_t (*real)(int, void*, size_t) = nullptr;
+    recordViolation(kRead);
+    return realFn(real, "read")(fd, b, n);
+}
+
+ssize_t write(int fd, const void* b, size_t n)
+{
+    static ssize_t (*real)(int, const void*, size_t) = nullptr;
+    recordViolation(kWrite);
+    return realFn(real, "write")(fd, b, n);
+}
+
+} // extern "C"
+
+#endif
@@ -0,0 +1,54 @@
+/**
+ * RealtimeSanitizer.h — Diagnostic build mode: catch non-realtime-safe calls
+ *
+ * Built only with -DKAWAII_RT_SANITIZER=ON. The sanitizer library interposes
+ * malloc/free, mutex/condvar waits and blocking syscalls (sleep, open, read,
+ * write). While a thread is inside a realtime scope — KawaiiProcessor::process()
+ * opens one — every interposed call records a backtrace into a preallocated
+ * buffer. The report is written at exit (or via writeReport()).
+ *
+ * Interposition needs the library loaded at process launch: the headless
+ * tools link it directly; for a DAW, launch it with
+ *   DYLD_INSERT_LIBRARIES=/path/to/libkawaii_rtsan.dylib
+ *
+ * Report path: $KAWAII_RTSAN_REPORT, default ./kawaii_rtsan_report.txt
+ *
+ * In normal builds KAWAII_RT_SCOPE() compiles to nothing.
+ */
+
+#pragma once
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+namespace RtSan {
+
+// Mark the calling thread as realtime / non-realtime (nestable)
+void enterRealtime();
+void exitRealtime();
+
+// Number of violations recorded so far (all threads)
+int violationCount();
+
+// Write the report now. Returns false if the file could not be opened.
+// Not realtime-safe — call from a non-audio thread.
+bool writeReport(const char* path = nullptr);
+
+struct ScopedRealtime
+{
+    ScopedRealtime()  { enterRealtime(); }
+    ~ScopedRealtime() { exitRealtime(); }
+    ScopedRealtime(const ScopedRealtime&) = delete;
+    ScopedRealtime& operator=(const ScopedRealtime&) = delete;
+};
+
+} // namespace RtSan
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
+
+#if KAWAII_RT_SANITIZER
+#define KAWAII_RT_SCOPE() ::Steinberg::Vst::Kawaii::RtSan::ScopedRealtime kawaiiRtScope_
+#else
+#define KAWAII_RT_SCOPE() ((void)0)
+#endif
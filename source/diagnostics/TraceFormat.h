@@ -0,0 +1,106 @@
+/**
+ * TraceFormat.h — Binary layout of process() traces (.ktrace)
+ *
+ * Written by TraceRecorder, read by tools/headless/kawaii_replay. Native
+ * byte order, packed records, no compression:
+ *
+ *   FileHeader
+ *   { uint8_t RecordType, then that record }...
+ *
+ *   kRecordActivate    ActivateRecord, then numParams doubles (params[] as
+ *                      the processor holds them after setActive(true))
+ *   kRecordBlock       BlockHeader, numEvents × EventRecord, then numQueues ×
+ *                      (QueueHeader, numPoints × PointRecord)
+ *   kRecordDeactivate  nothing
+ *   kRecordState       numParams doubles: params after a setState() while
+ *                      active, applied before the next block
+ *
+ * Decisions are the engine choices made from timing rather than from the
+ * inputs (quality tier, render path). They are stored per block so a replay
+ * can script them and reproduce the recorded run exactly.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+namespace Trace {
+
+static constexpr char     kMagic[4] = { 'K', 'W', 'T', 'R' };
+static constexpr uint32_t kVersion  = 2;   // 2: kRecordState
+
+enum RecordType : uint8_t
+{
+    kRecordActivate   = 1,
+    kRecordBlock      = 2,
+    kRecordDeactivate = 3,
+    kRecordState      = 4,
+};
+
+#pragma pack(push, 1)
+
+struct FileHeader
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t numParams;
+};
+
+struct Decisions
+{
+    uint8_t tier;         // QualityGovernor tier at the end of the block
+    uint8_t overBudget;   // governor load above kHighLoad at the end of the block
+    uint8_t offload;      // render path in use at the end of the block
+};
+
+struct ActivateRecord
+{
+    double  sampleRate;
+    int32_t maxSamplesPerBlock;
+    int32_t processMode;
+    uint8_t offload;      // path chosen at activation
+};
+
+struct BlockHeader
+{
+    int32_t   numSamples;
+    int32_t   processMode;
+    Decisions decisions;
+    uint32_t  droppedBefore;   // blocks lost to a full buffer just before this one
+    uint16_t  numEvents;
+    uint16_t  numQueues;
+};
+
+struct EventRecord
+{
+    uint16_t type;
+    int32_t  sampleOffset;
+    int16_t  channel;
+    int16_t  pitch;
+    float    tuning;
+    float    velocity;
+    int32_t  length;       // note-on only
+    int32_t  noteId;
+};
+
+struct QueueHeader
+{
+    uint32_t paramId;
+    uint16_t numPoints;
+};
+
+struct PointRecord
+{
+    int32_t sampleOffset;
+    double  value;
+};
+
+#pragma pack(pop)
+
+} // namespace Trace
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
@@ -0,0 +1,271 @@
+/**
+ * TraceRecorder.cpp — Lock-free block recorder + background file writer
+ */
+
+#include "TraceRecorder.h"
+#include "pluginterfaces/vst/ivstevents.h"
+#include "pluginterfaces/vst/ivstparameterchanges.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+namespace {
+
+constexpr auto kWriterInterval = std::chrono::milliseconds(20);
+
+std::atomic<int> instanceCounter { 0 };
+
+Trace::EventRecord toRecord(const Event& e)
+{
+    Trace::EventRecord r {};
+    r.type = e.type;
+    r.sampleOffset = e.sampleOffset;
+    if (e.type == Event::kNoteOnEvent)
+    {
+        r.channel  = e.noteOn.channel;
+        r.pitch    = e.noteOn.pitch;
+        r.tuning   = e.noteOn.tuning;
+        r.velocity = e.noteOn.velocity;
+        r.length   = e.noteOn.length;
+        r.noteId   = e.noteOn.noteId;
+    }
+    else if (e.type == Event::kNoteOffEvent)
+    {
+        r.channel  = e.noteOff.channel;
+        r.pitch    = e.noteOff.pitch;
+        r.tuning   = e.noteOff.tuning;
+        r.velocity = e.noteOff.velocity;
+        r.noteId   = e.noteOff.noteId;
+    }
+    return r;
+}
+
+} // namespace
+
+std::unique_ptr<TraceRecorder> TraceRecorder::createFromEnvironment(int numParams)
+{
+    const char* dir = getenv("KAWAII_TRACE_DIR");
+    if (!dir || !*dir)
+        return nullptr;
+
+    std::string path = std::string(dir) + "/kawaii_" + std::to_string(getpid()) + "_"
+                     + std::to_string(instanceCounter.fetch_add(1)) + ".ktrace";
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file)
+        return nullptr;
+
+    Trace::FileHeader header {};
+    memcpy(header.magic, Trace::kMagic, sizeof(header.magic));
+    header.version = Trace::kVersion;
+    header.numParams = static_cast<uint32_t>(numParams);
+    fwrite(&header, sizeof(header), 1, file);
+
+    return std::unique_ptr<TraceRecorder>(new TraceRecorder(file, numParams));
+}
+
+TraceRecorder::TraceRecorder(FILE* f, int n)
+    : file(f)
+    , numParams(n)
+    , ring(new uint8_t[kRingBytes])
+    , stateSnapshot(new double[(size_t)n])
+{
+    writer = std::thread([this] { writerLoop(); });
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    running.store(false);
+    if (writer.joinable())
+        writer.join();
+    drain();
+    fclose(file);
+}
+
+bool TraceRecorder::begin(size_t bytes)
+{
+    uint64_t h = head.load(std::memory_order_relaxed);
+    uint64_t t = tail.load(std::memory_order_acquire);
+    if (kRingBytes - (size_t)(h - t) < bytes)
+        return false;
+    pending = h;
+    return true;
+}
+
+void TraceRecorder::put(const void* src, size_t bytes)
+{
+    size_t pos = (size_t)(pending % kRingBytes);
+    size_t first = std::min(bytes, kRingBytes - pos);
+    memcpy(ring.get() + pos, src, first);
+    memcpy(ring.get(), static_cast<const uint8_t*>(src) + first, bytes - first);
+    pending += bytes;
+}
+
+void TraceRecorder::commit()
+{
+    head.store(pending, std::memory_order_release);
+}
+
+void TraceRecorder::recordActivate(const ProcessSetup& setup, bool offload, const ParamValue* params)
+{
+    while (stateBusy.exchange(true, std::memory_order_acquire))
+        std::this_thread::yield();
+    statePending.store(false, std::memory_order_relaxed);
+    stateBusy.store(false, std::memory_order_release);
+
+    Trace::ActivateRecord r {};
+    r.sampleRate = setup.sampleRate;
+    r.maxSamplesPerBlock = setup.maxSamplesPerBlock;
+    r.processMode = setup.processMode;
+    r.offload = offload ? 1 : 0;
+
+    uint8_t type = Trace::kRecordActivate;
+    size_t paramBytes = (size_t)numParams * sizeof(double);
+
+    // Not on the audio thread: wait for room rather than lose the setup
+    while (!begin(sizeof(type) + sizeof(r) + paramBytes))
+        std::this_thread::sleep_for(kWriterInterval);
+    put(&type, sizeof(type));
+    put(&r, sizeof(r));
+    for (int i = 0; i < numParams; i++)
+    {
+        double value = params[i];
+        put(&value, sizeof(value));
+    }
+    commit();
+}
+
+void TraceRecorder::recordDeactivate()
+{
+    uint8_t type = Trace::kRecordDeactivate;
+    while (!begin(sizeof(type)))
+        std::this_thread::sleep_for(kWriterInterval);
+    put(&type, sizeof(type));
+    commit();
+}
+
+void TraceRecorder::recordState(const ParamValue* params)
+{
+    while (stateBusy.exchange(true, std::memory_order_acquire))
+        std::this_thread::yield();
+    for (int i = 0; i < numParams; i++)
+        stateSnapshot[(size_t)i] = params[i];
+    statePending.store(true, std::memory_order_relaxed);
+    stateBusy.store(false, std::memory_order_release);
+}
+
+void TraceRecorder::recordPendingState()
+{
+    if (!statePending.load(std::memory_order_relaxed) || stateBusy.exchange(true, std::memory_order_acquire))
+        return;
+
+    uint8_t type = Trace::kRecordState;
+    if (statePending.load(std::memory_order_relaxed)
+        && begin(sizeof(type) + (size_t)numParams * sizeof(double)))
+    {
+        put(&type, sizeof(type));
+        put(stateSnapshot.get(), (size_t)numParams * sizeof(double));
+        commit();
+        statePending.store(false, std::memory_order_relaxed);
+    }
+    stateBusy.store(false, std::memory_order_release);
+}
+
+void TraceRecorder::recordBlock(ProcessData& data, const Trace::Decisions& decisions)
+{
+    IEventList* events = data.inputEvents;
+    IParameterChanges* changes = data.inputParameterChanges;
+    int32 numEvents = events ? std::min(events->getEventCount(), (int32)UINT16_MAX) : 0;
+    int32 numQueues = changes ? std::min(changes->getParameterCount(), (int32)UINT16_MAX) : 0;
+
+    // Size the whole record first, so it is written completely or not at all
+    size_t bytes = sizeof(uint8_t) + sizeof(Trace::BlockHeader)
+                 + (size_t)numEvents * sizeof(Trace::EventRecord);
+    for (int32 q = 0; q < numQueues; q++)
+    {
+        IParamValueQueue* queue = changes->getParameterData(q);
+        int32 points = queue ? std::min(queue->getPointCount(), (int32)UINT16_MAX) : 0;
+        bytes += sizeof(Trace::QueueHeader) + (size_t)points * sizeof(Trace::PointRecord);
+    }
+
+    if (!begin(bytes))
+    {
+        droppedBlocks++;
+        return;
+    }
+
+    uint8_t type = Trace::kRecordBlock;
+    Trace::BlockHeader header {};
+    header.numSamples = data.numSamples;
+    header.processMode = data.processMode;
+    header.decisions = decisions;
+    header.droppedBefore = droppedBlocks;
+    header.numEvents = static_cast<uint16_t>(numEvents);
+    header.numQueues = static_cast<uint16_t>(numQueues);
+    put(&type, sizeof(type));
+    put(&header, sizeof(header));
+
+    for (int32 i = 0; i < numEvents; i++)
+    {
+        Event e {};
+        events->getEvent(i, e);
+        Trace::EventRecord r = toRecord(e);
+        put(&r, sizeof(r));
+    }
+
+    for (int32 q = 0; q < numQueues; q++)
+    {
+        IParamValueQueue* queue = changes->getParameterData(q);
+        Trace::QueueHeader qh {};
+        qh.paramId = queue ? queue->getParameterId() : 0;
+        qh.numPoints = static_cast<uint16_t>(queue ? std::min(queue->getPointCount(), (int32)UINT16_MAX) : 0);
+        put(&qh, sizeof(qh));
+
+        for (int32 p = 0; p < qh.numPoints; p++)
+        {
+            int32 sampleOffset = 0;
+            ParamValue value = 0.0;
+            queue->getPoint(p, sampleOffset, value);
+            Trace::PointRecord pr { sampleOffset, value };
+            put(&pr, sizeof(pr));
+        }
+    }
+
+    commit();
+    droppedBlocks = 0;
+}
+
+void TraceRecorder::writerLoop()
+{
+    while (running.load())
+    {
+        drain();
+        std::this_thread::sleep_for(kWriterInterval);
+    }
+}
+
+void TraceRecorder::drain()
+{
+    uint64_t t = tail.load(std::memory_order_relaxed);
+    uint64_t h = head.load(std::memory_order_acquire);
+    while (t < h)
+    {
+        size_t pos = (size_t)(t % kRingBytes);
+        size_t chunk = std::min((size_t)(h - t), kRingBytes - pos);
+        fwrite(ring.get() + pos, 1, chunk, file);
+        t += chunk;
+    }
+    tail.store(t, std::memory_order_release);
+    fflush(file);
+}
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
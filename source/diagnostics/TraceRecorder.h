@@ -0,0 +1,98 @@
+/**
+ * TraceRecorder.h — Diagnostic build mode: record process() inputs
+ *
+ * Built into the processor with -DKAWAII_TRACE_RECORDER=ON and active when
+ * $KAWAII_TRACE_DIR is set: each processor instance then writes
+ *   $KAWAII_TRACE_DIR/kawaii_<pid>_<instance>.ktrace
+ * holding every activation's setup and params, every state load and every
+ * block's events, parameter queue points, size, process mode and
+ * timing-driven decisions (see TraceFormat.h). tools/headless/kawaii_replay plays a trace back
+ * through the headless processor.
+ *
+ * recordBlock() is realtime-safe: it serializes into a preallocated
+ * single-producer ring with two atomics and never waits. A background
+ * thread drains the ring to the file. If the ring is full the block is
+ * dropped and the next written block says how many were lost.
+ *
+ * The recording calls (activate/deactivate from setActive(), blocks from
+ * process()) all come from the one "producer" side; hosts never run them
+ * concurrently. setState() may run on another thread while processing, so
+ * recordState() only leaves a snapshot; process() writes it to the ring
+ * (recordPendingState) before its block.
+ */
+
+#pragma once
+
+#include "TraceFormat.h"
+#include "pluginterfaces/vst/ivstaudioprocessor.h"
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+class TraceRecorder
+{
+public:
+    static constexpr size_t kRingBytes = size_t(8) << 20;   // ~seconds of dense automation
+
+    // A recorder writing to a new file in $KAWAII_TRACE_DIR, or nullptr if
+    // the variable is unset or the file cannot be created
+    static std::unique_ptr<TraceRecorder> createFromEnvironment(int numParams);
+
+    ~TraceRecorder();
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    void recordActivate(const ProcessSetup& setup, bool offload, const ParamValue* params);
+    void recordDeactivate();
+
+    // Any thread: params after a setState(). Activation records carry the
+    // params themselves, so a snapshot still pending then is dropped.
+    void recordState(const ParamValue* params);
+
+    // Realtime-safe. Call at the start of process(); a snapshot that does
+    // not fit the ring yet stays pending for the next block.
+    void recordPendingState();
+
+    // Realtime-safe. Call after the block rendered (decisions are its outcome).
+    void recordBlock(ProcessData& data, const Trace::Decisions& decisions);
+
+private:
+    TraceRecorder(FILE* file, int numParams);
+
+    // Producer side: claim space for a whole record, fill it, publish it
+    bool begin(size_t bytes);
+    void put(const void* src, size_t bytes);
+    void commit();
+
+    void writerLoop();
+    void drain();
+
+    FILE* file = nullptr;
+    int numParams = 0;
+
+    std::unique_ptr<uint8_t[]> ring;
+    std::atomic<uint64_t> head { 0 };   // written up to (producer)
+    std::atomic<uint64_t> tail { 0 };   // drained up to (writer thread)
+    uint64_t pending = 0;               // producer's position inside a record
+    uint32_t droppedBlocks = 0;
+
+    // Latest setState() snapshot, handed over under stateBusy (a spin lock
+    // the audio side only ever try-locks)
+    std::unique_ptr<double[]> stateSnapshot;
+    std::atomic<bool> stateBusy { false };
+    std::atomic<bool> statePending { false };
+
+    std::atomic<bool> running { true };
+    std::thread writer;
+};
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
@@ -7,6 +7,7 @@
 #include "vstgui/lib/controls/coptionmenu.h"
 #include "vstgui/lib/cframe.h"
 
+#include <algorithm>
 #include <cstdio>
 
 namespace Steinberg {
@@ -15,7 +16,7 @@ namespace Kawaii {
 
 using namespace VSTGUI;
 
-// Layout constants — 4 groups of 8 partials + filter strip at bottom
+// Layout constants — a page of 4 groups of 8 partials + filter strip at bottom
 static constexpr int kWindowW = 1280;
 static constexpr int kWindowH = 580;
 
@@ -33,19 +34,22 @@ static constexpr int kTitleY = 8;
 static constexpr int kMasterY = 6;
 static constexpr int kGridTop = 52;   // partials start closer to top
 
-// 4 groups of 8 partials across
+// 4 groups of 8 partials across; Partial Counts above 32 page through them
 static constexpr int kPartialsPerGroup = 8;
+static constexpr int kGroupsPerPage = 4;
+static constexpr int kPartialsPerPage = kGroupsPerPage * kPartialsPerGroup;  // 32
 static constexpr int kGroupGap = 12;
 static constexpr int kGroupW = kRowLabelW + 5 * kColW;  // 308px
 
 static constexpr int kMarginLeft = 8;
-static constexpr int kGroup1Left = kMarginLeft;
-static constexpr int kGroup2Left = kGroup1Left + kGroupW + kGroupGap;
-static constexpr int kGroup3Left = kGroup2Left + kGroupW + kGroupGap;
-static constexpr int kGroup4Left = kGroup3Left + kGroupW + kGroupGap;
+
+// Page selector, top right; its tag is not a parameter
+static constexpr int kPageMenuW = 130;
+static constexpr int32 kPageMenuTag = -1;
 
 // Filter section — horizontal strip below the partial grid
 static constexpr int kGridBottom = kGridTop + kPartialsPerGroup * kRowH;  // 52 + 416 = 468
+static constexpr int kGridContainerTop = kGridTop - 12;  // group titles sit above the rows
 static constexpr int kFilterY = kGridBottom + 14;  // 482
 static constexpr int kFilterKnobSize = 32;
 static constexpr int kFilterColW = 62;
@@ -53,6 +57,17 @@ static constexpr int kFilterColW = 62;
 // Zoom factor for shift+drag fine control: higher = finer when dragging far from knob
 static constexpr float kKnobZoomFactor = 8.0f;
 
+// Colors
+static const CColor kLabelColor(190, 190, 200, 255);
+static const CColor kValueColor(130, 130, 145, 255);   // dimmer than name labels
+static const CColor kTitleColor(255, 160, 210, 255);   // kawaii pink
+static const CColor kHeaderColor(140, 140, 160, 255);
+static const CColor kKnobCorona(255, 140, 200, 255);   // pink arc
+static const CColor kKnobTrack(55, 55, 65, 255);       // dark arc track
+static const CColor kKnobDot(255, 180, 220, 255);      // pink dot handle
+static const CColor kFilterCorona(100, 200, 255, 255); // blue arc for filter
+static const CColor kFilterDot(140, 220, 255, 255);    // blue dot for filter
+
 KawaiiEditor::KawaiiEditor(void* controller)
     : VSTGUIEditor(static_cast<EditController*>(controller))
 {
@@ -69,6 +84,7 @@ bool PLUGIN_API KawaiiEditor::open(void* parent, const PlatformType& platformTyp
     frame->setBackgroundColor(CColor(30, 30, 36, 255));
 
     valueLabels.clear();
+    page = 0;
     createControls();
 
     if (frame && frame->open(parent, platformType))
@@ -80,6 +96,8 @@ bool PLUGIN_API KawaiiEditor::open(void* parent, const PlatformType& platformTyp
 void PLUGIN_API KawaiiEditor::close()
 {
     valueLabels.clear();  // pointers owned by frame, will be deleted with it
+    partialGrid = nullptr;
+    pageMenu = nullptr;
     if (frame)
     {
         frame->forget();
@@ -89,6 +107,13 @@ void PLUGIN_API KawaiiEditor::close()
 
 void KawaiiEditor::valueChanged(CControl* control)
 {
+    if (control == pageMenu)
+    {
+        page = static_cast<int>(pageMenu->getCurrentIndex());
+        buildPartialGrid();
+        return;
+    }
+
     ParamID tag = control->getTag();
     ParamValue value = control->getValue();
 
@@ -131,102 +156,109 @@ void KawaiiEditor::updateValueLabel(Vst::ParamID tag, double value)
     it->second->setText(buf);
 }
 
-void KawaiiEditor::createControls()
+// Styled corona knob with name label + value label below, added to parent
+void KawaiiEditor::makeKnob(CViewContainer* parent, const char* name, ParamID tag, int x, int y,
+                            int size, const CColor& corona, const CColor& dot)
 {
-    if (!frame) return;
-
-    CColor labelColor(190, 190, 200, 255);
-    CColor valueColor(130, 130, 145, 255);  // dimmer than name labels
-    CColor titleColor(255, 160, 210, 255);   // kawaii pink
-    CColor headerColor(140, 140, 160, 255);
-    CColor knobCorona(255, 140, 200, 255);   // pink arc
-    CColor knobTrack(55, 55, 65, 255);       // dark arc track
-    CColor knobDot(255, 180, 220, 255);      // pink dot handle
-    CColor filterCorona(100, 200, 255, 255); // blue arc for filter
-    CColor filterDot(140, 220, 255, 255);    // blue dot for filter
-
-    // --- Helper: create a styled corona knob with name label + value label below ---
-    auto makeKnob = [&](const char* name, ParamID tag, int x, int y,
-                        int size, CColor corona, CColor dot) {
-        CRect knobRect(x, y, x + size, y + size);
-        auto* knob = new CKnob(knobRect, this, tag, nullptr, nullptr);
-
-        knob->setDrawStyle(
-            CKnob::kCoronaOutline |
-            CKnob::kCoronaDrawing |
-            CKnob::kHandleCircleDrawing |
-            CKnob::kCoronaLineCapButt
-        );
-        knob->setCoronaInset(2);
-        knob->setHandleLineWidth(2.5);
-        knob->setCoronaColor(corona);
-        knob->setColorShadowHandle(knobTrack);
-        knob->setColorHandle(dot);
-
-        // Zoom factor: dragging further from knob center = finer control.
-        // Combined with shift key, this gives very precise adjustment.
-        knob->setZoomFactor(kKnobZoomFactor);
-
-        float initValue = 0.0f;
-        if (getController())
-        {
-            initValue = static_cast<float>(getController()->getParamNormalized(tag));
-            knob->setValue(initValue);
-        }
+    CRect knobRect(x, y, x + size, y + size);
+    auto* knob = new CKnob(knobRect, this, tag, nullptr, nullptr);
+
+    knob->setDrawStyle(
+        CKnob::kCoronaOutline |
+        CKnob::kCoronaDrawing |
+        CKnob::kHandleCircleDrawing |
+        CKnob::kCoronaLineCapButt
+    );
+    knob->setCoronaInset(2);
+    knob->setHandleLineWidth(2.5);
+    knob->setCoronaColor(corona);
+    knob->setColorShadowHandle(kKnobTrack);
+    knob->setColorHandle(dot);
+
+    // Zoom factor: dragging further from knob center = finer control.
+    // Combined with shift key, this gives very precise adjustment.
+    knob->setZoomFactor(kKnobZoomFactor);
+
+    float initValue = 0.0f;
+    if (getController())
+    {
+        initValue = static_cast<float>(getController()->getParamNormalized(tag));
+        knob->setValue(initValue);
+    }
 
-        frame->addView(knob);
-
-        // Name label below knob
-        CRect labelRect(x - 10, y + size + 1, x + size + 10, y + size + 1 + kLabelH);
-        auto* label = new CTextLabel(labelRect, name);
-        label->setFontColor(labelColor);
-        label->setBackColor(CColor(0, 0, 0, 0));
-        label->setFrameColor(CColor(0, 0, 0, 0));
-        label->setFont(kNormalFontVerySmall);
-        label->setHoriAlign(CHoriTxtAlign::kCenterText);
-        frame->addView(label);
-
-        // Value label below name label — shows normalized value with 6 sig digits
-        int valY = y + size + 1 + kLabelH;
-        CRect valRect(x - 12, valY, x + size + 12, valY + kValueLabelH);
-        char buf[16];
-        snprintf(buf, sizeof(buf), "%.6g", static_cast<double>(initValue));
-        auto* valLabel = new CTextLabel(valRect, buf);
-        valLabel->setFontColor(valueColor);
-        valLabel->setBackColor(CColor(0, 0, 0, 0));
-        valLabel->setFrameColor(CColor(0, 0, 0, 0));
-        valLabel->setFont(kNormalFontVerySmall);
-        valLabel->setHoriAlign(CHoriTxtAlign::kCenterText);
-        frame->addView(valLabel);
-
-        // Store reference so valueChanged can update it
-        valueLabels[static_cast<int32>(tag)] = valLabel;
-    };
+    parent->addView(knob);
+
+    // Name label below knob
+    CRect labelRect(x - 10, y + size + 1, x + size + 10, y + size + 1 + kLabelH);
+    auto* label = new CTextLabel(labelRect, name);
+    label->setFontColor(kLabelColor);
+    label->setBackColor(CColor(0, 0, 0, 0));
+    label->setFrameColor(CColor(0, 0, 0, 0));
+    label->setFont(kNormalFontVerySmall);
+    label->setHoriAlign(CHoriTxtAlign::kCenterText);
+    parent->addView(label);
+
+    // Value label below name label — shows normalized value with 6 sig digits
+    int valY = y + size + 1 + kLabelH;
+    CRect valRect(x - 12, valY, x + size + 12, valY + kValueLabelH);
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%.6g", static_cast<double>(initValue));
+    auto* valLabel = new CTextLabel(valRect, buf);
+    valLabel->setFontColor(kValueColor);
+    valLabel->setBackColor(CColor(0, 0, 0, 0));
+    valLabel->setFrameColor(CColor(0, 0, 0, 0));
+    valLabel->setFont(kNormalFontVerySmall);
+    valLabel->setHoriAlign(CHoriTxtAlign::kCenterText);
+    parent->addView(valLabel);
+
+    // Store reference so valueChanged can update it
+    valueLabels[static_cast<int32>(tag)] = valLabel;
+}
 
-    auto partialKnob = [&](const char* name, ParamID tag, int x, int y) {
-        makeKnob(name, tag, x, y, kKnobSize, knobCorona, knobDot);
-    };
+// The controller's Partial Count (not the processor's active one: knobs of
+// partials the next activation renders are worth editing already)
+int KawaiiEditor::partialCount() const
+{
+    if (!getController())
+        return kPartialCountOptions[kDefaultPartialCountIndex];
+    return partialCountFromNormalized(getController()->getParamNormalized(kParamPartialCount));
+}
 
-    auto filterKnob = [&](const char* name, ParamID tag, int x, int y) {
-        makeKnob(name, tag, x, y, kFilterKnobSize, filterCorona, filterDot);
-    };
+void KawaiiEditor::partialCountChanged()
+{
+    if (!frame || !partialGrid)
+        return;
+    updatePageMenu();
+    buildPartialGrid();
+}
 
-    // --- Title ---
-    CRect titleRect(14, kTitleY, 200, kTitleY + 24);
-    auto* title = new CTextLabel(titleRect, "KAWAII K50V");
-    title->setFontColor(titleColor);
-    title->setBackColor(CColor(0, 0, 0, 0));
-    title->setFrameColor(CColor(0, 0, 0, 0));
-    title->setFont(kNormalFontBig);
-    title->setHoriAlign(CHoriTxtAlign::kLeftText);
-    frame->addView(title);
+// One entry per page of the current Partial Count; hidden while one page
+// holds them all
+void KawaiiEditor::updatePageMenu()
+{
+    int numPages = (partialCount() + kPartialsPerPage - 1) / kPartialsPerPage;
+    page = std::min(page, numPages - 1);
 
-    // --- Master knobs (top area, after title) ---
-    partialKnob("Volume", kParamMasterVolume, 180, kMasterY);
+    pageMenu->removeAllEntry();
+    for (int i = 0; i < numPages; i++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "Partials %d-%d", i * kPartialsPerPage + 1, (i + 1) * kPartialsPerPage);
+        pageMenu->addEntry(name);
+    }
+    pageMenu->setCurrent(page);
+    pageMenu->setVisible(numPages > 1);
+    pageMenu->invalid();
+}
 
-    // ===================================================================
-    // PARTIALS GRID — 4 groups of 8
-    // ===================================================================
+// Fill partialGrid with the current page's groups, up to the Partial Count
+void KawaiiEditor::buildPartialGrid()
+{
+    // The grid's value labels go with its views
+    for (int p = 0; p < kMaxPartials; p++)
+        for (int c = 0; c < kPartialParamStride; c++)
+            valueLabels.erase(static_cast<int32>(partialParam(p, c)));
+    partialGrid->removeAll();
 
     static const char* colLabels[] = {"Level", "Atk", "Dec", "Sus", "Rel"};
     static const int offsets[] = {
@@ -234,50 +266,103 @@ void KawaiiEditor::createControls()
         kPartialOffSustain, kPartialOffRelease
     };
 
-    auto makeGroup = [&](int groupLeft, int startPartial, const char* groupTitle) {
+    // Views are placed in the container's coordinates
+    auto makeGroup = [&](int groupLeft, int startPartial) {
         // Group title
-        CRect grpRect(groupLeft, kGridTop - 12, groupLeft + kGroupW, kGridTop);
+        char groupTitle[32];
+        snprintf(groupTitle, sizeof(groupTitle), "Partials %d-%d",
+                 startPartial + 1, startPartial + kPartialsPerGroup);
+        CRect grpRect(groupLeft, 0, groupLeft + kGroupW, kGridTop - kGridContainerTop);
         auto* grpLabel = new CTextLabel(grpRect, groupTitle);
-        grpLabel->setFontColor(headerColor);
+        grpLabel->setFontColor(kHeaderColor);
         grpLabel->setBackColor(CColor(0, 0, 0, 0));
         grpLabel->setFrameColor(CColor(0, 0, 0, 0));
         grpLabel->setFont(kNormalFontVerySmall);
         grpLabel->setHoriAlign(CHoriTxtAlign::kLeftText);
-        frame->addView(grpLabel);
+        partialGrid->addView(grpLabel);
 
         int knobsLeft = groupLeft + kRowLabelW;
 
         for (int i = 0; i < kPartialsPerGroup; i++)
         {
             int p = startPartial + i;
-            int y = kGridTop + i * kRowH;
+            int y = kGridTop - kGridContainerTop + i * kRowH;
 
             // Row label (P1, P2, etc.)
             char rowLabel[8];
             snprintf(rowLabel, sizeof(rowLabel), "P%d", p + 1);
             CRect rowRect(groupLeft, y + 6, groupLeft + kRowLabelW - 2, y + 6 + kLabelH);
             auto* rl = new CTextLabel(rowRect, rowLabel);
-            rl->setFontColor(headerColor);
+            rl->setFontColor(kHeaderColor);
             rl->setBackColor(CColor(0, 0, 0, 0));
             rl->setFrameColor(CColor(0, 0, 0, 0));
             rl->setFont(kNormalFontVerySmall);
             rl->setHoriAlign(CHoriTxtAlign::kRightText);
-            frame->addView(rl);
+            partialGrid->addView(rl);
 
             // 5 knobs per partial
             for (int c = 0; c < 5; c++)
             {
                 int x = knobsLeft + c * kColW;
                 ParamID tag = partialParam(p, offsets[c]);
-                partialKnob(colLabels[c], tag, x, y);
+                makeKnob(partialGrid, colLabels[c], tag, x, y, kKnobSize, kKnobCorona, kKnobDot);
             }
         }
     };
 
-    makeGroup(kGroup1Left, 0,  "Partials 1-8");
-    makeGroup(kGroup2Left, 8,  "Partials 9-16");
-    makeGroup(kGroup3Left, 16, "Partials 17-24");
-    makeGroup(kGroup4Left, 24, "Partials 25-32");
+    int first = page * kPartialsPerPage;
+    int last = std::min(first + kPartialsPerPage, partialCount());
+    for (int g = 0; first + g * kPartialsPerGroup < last; g++)
+        makeGroup(kMarginLeft + g * (kGroupW + kGroupGap), first + g * kPartialsPerGroup);
+
+    partialGrid->invalid();
+}
+
+void KawaiiEditor::createControls()
+{
+    if (!frame) return;
+
+    auto partialKnob = [&](const char* name, ParamID tag, int x, int y) {
+        makeKnob(frame, name, tag, x, y, kKnobSize, kKnobCorona, kKnobDot);
+    };
+
+    auto filterKnob = [&](const char* name, ParamID tag, int x, int y) {
+        makeKnob(frame, name, tag, x, y, kFilterKnobSize, kFilterCorona, kFilterDot);
+    };
+
+    // --- Title ---
+    CRect titleRect(14, kTitleY, 200, kTitleY + 24);
+    auto* title = new CTextLabel(titleRect, "KAWAII K50V");
+    title->setFontColor(kTitleColor);
+    title->setBackColor(CColor(0, 0, 0, 0));
+    title->setFrameColor(CColor(0, 0, 0, 0));
+    title->setFont(kNormalFontBig);
+    title->setHoriAlign(CHoriTxtAlign::kLeftText);
+    frame->addView(title);
+
+    // --- Master knobs (top area, after title) ---
+    partialKnob("Volume", kParamMasterVolume, 180, kMasterY);
+
+    // ===================================================================
+    // PARTIALS GRID — pages of 4 groups of 8, as many as Partial Count has
+    // ===================================================================
+
+    int pageMenuLeft = kWindowW - kMarginLeft - kPageMenuW;
+    CRect pageMenuRect(pageMenuLeft, kTitleY, pageMenuLeft + kPageMenuW, kTitleY + 22);
+    pageMenu = new COptionMenu(pageMenuRect, this, kPageMenuTag);
+    pageMenu->setFontColor(kTitleColor);
+    pageMenu->setBackColor(CColor(45, 45, 55, 255));
+    pageMenu->setFrameColor(CColor(70, 70, 85, 255));
+    pageMenu->setFont(kNormalFontSmall);
+    frame->addView(pageMenu);
+
+    CRect gridRect(0, kGridContainerTop, kWindowW, kGridBottom);
+    partialGrid = new CViewContainer(gridRect);
+    partialGrid->setTransparency(true);
+    frame->addView(partialGrid);
+
+    updatePageMenu();
+    buildPartialGrid();
 
     // ===================================================================
     // FILTER SECTION — horizontal strip at the bottom
@@ -292,7 +377,7 @@ void KawaiiEditor::createControls()
     // "FILTER" label
     CRect fltTitleRect(16, kFilterY - 2, 100, kFilterY + 14);
     auto* fltTitle = new CTextLabel(fltTitleRect, "FILTER");
-    fltTitle->setFontColor(filterCorona);
+    fltTitle->setFontColor(kFilterCorona);
     fltTitle->setBackColor(CColor(0, 0, 0, 0));
     fltTitle->setFrameColor(CColor(0, 0, 0, 0));
     fltTitle->setFont(kNormalFontSmall);
@@ -308,7 +393,7 @@ void KawaiiEditor::createControls()
         for (int i = 0; i < kNumFilterTypes; i++)
             typeMenu->addEntry(filterTypes[(size_t)i].name);
     }
-    typeMenu->setFontColor(filterCorona);
+    typeMenu->setFontColor(kFilterCorona);
     typeMenu->setBackColor(CColor(45, 45, 55, 255));
     typeMenu->setFrameColor(CColor(70, 70, 85, 255));
     typeMenu->setFont(kNormalFontSmall);
@@ -325,7 +410,7 @@ void KawaiiEditor::createControls()
     // "Type" label below menu
     CRect typeLblRect(typeX, kFilterY + 24, typeX + 120, kFilterY + 24 + kLabelH);
     auto* typeLbl = new CTextLabel(typeLblRect, "Type");
-    typeLbl->setFontColor(labelColor);
+    typeLbl->setFontColor(kLabelColor);
     typeLbl->setBackColor(CColor(0, 0, 0, 0));
     typeLbl->setFrameColor(CColor(0, 0, 0, 0));
     typeLbl->setFont(kNormalFontVerySmall);
@@ -340,7 +425,7 @@ void KawaiiEditor::createControls()
     subMenu->addEntry("Sub 2");
     subMenu->addEntry("Sub 3");
     subMenu->addEntry("Sub 4");
-    subMenu->setFontColor(filterCorona);
+    subMenu->setFontColor(kFilterCorona);
     subMenu->setBackColor(CColor(45, 45, 55, 255));
     subMenu->setFrameColor(CColor(70, 70, 85, 255));
     subMenu->setFont(kNormalFontSmall);
@@ -356,7 +441,7 @@ void KawaiiEditor::createControls()
     // "Sub" label below subtype menu
     CRect subLblRect(subX, kFilterY + 24, subX + 60, kFilterY + 24 + kLabelH);
     auto* subLbl = new CTextLabel(subLblRect, "Sub");
-    subLbl->setFontColor(labelColor);
+    subLbl->setFontColor(kLabelColor);
     subLbl->setBackColor(CColor(0, 0, 0, 0));
     subLbl->setFrameColor(CColor(0, 0, 0, 0));
     subLbl->setFont(kNormalFontVerySmall);
@@ -4,7 +4,7 @@
 #include "../entry/KawaiiCids.h"
 #include <unordered_map>
 
-namespace VSTGUI { class CTextLabel; }
+namespace VSTGUI { class CTextLabel; class CViewContainer; class COptionMenu; struct CColor; }
 
 namespace Steinberg {
 namespace Vst {
@@ -22,10 +22,24 @@ public:
     // IControlListener — called when user moves a knob
     void valueChanged(VSTGUI::CControl* control) override;
 
+    // The controller's Partial Count changed: re-page the partial grid
+    void partialCountChanged();
+
 private:
     void createControls();
+    void makeKnob(VSTGUI::CViewContainer* parent, const char* name, Vst::ParamID tag,
+                  int x, int y, int size, const VSTGUI::CColor& corona, const VSTGUI::CColor& dot);
     void updateValueLabel(Vst::ParamID tag, double value);
 
+    // Partial grid paging: one page shows up to 4 groups of 8 partials
+    int partialCount() const;
+    void updatePageMenu();
+    void buildPartialGrid();
+
+    VSTGUI::CViewContainer* partialGrid = nullptr;  // owned by frame
+    VSTGUI::COptionMenu* pageMenu = nullptr;         // owned by frame
+    int page = 0;
+
     // Map from param ID to its value display label, so valueChanged can update it
     std::unordered_map<int32, VSTGUI::CTextLabel*> valueLabels;
 };
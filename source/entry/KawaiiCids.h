@@ -1,8 +1,8 @@
 /**
  * KawaiiCids.h — Component IDs and Parameter Definitions
  *
- * "Kawaii K50V" — 32-partial additive synth with per-partial ADSR
- *                 and Surge XT sst-filters (33 filter types).
+ * "Kawaii K50V" — additive synth (8–128 partials, 32 by default) with
+ *                 per-partial ADSR and Surge XT sst-filters (33 filter types).
  *
  * Parameter layout (contiguous IDs — no gaps):
  *   0        Master Volume
@@ -21,7 +21,31 @@
  *   169      Filter Env Depth (bipolar: 0.5 = none)
  *   170      Filter Keytrack
  *   171      Filter SubType (0–3, subtype variant)
- *   kNumParams = 172
+ *   172      Partial Count (8/16/32/64/128, applied at setActive)
+ *   173-177  Partial 33 (Level, Attack, Decay, Sustain, Release)
+ *   ...
+ *   648-652  Partial 128
+ *   653      Filter Oversampling (Off/2×/4×)
+ *   654      Filter Mode (Time Domain/Spectral)
+ *   655      Partial Rendering (Full Rate/Multi-Rate)
+ *   656      Quality (Auto/Full/Cull Partials/Fast Sine/No Filter Oversampling/Shed Voices)
+ *   657      Render Backend (Inline CPU/Offload; read-only output from the processor)
+ *   658      Memory Footprint (MB; read-only output from the processor)
+ *   659      Pitch Bend (bipolar: 0.5 = none; hosts map MIDI pitch bend here)
+ *   660      Pitch Bend Range (0–24 semitones)
+ *   661-788  Tuning: pitch of MIDI notes 0–127 (default 12-TET)
+ *   789      Mod Wheel (hosts map MIDI CC 1 here)
+ *   790-791  LFO 1 (per voice, restarts at note-on): Rate, Shape
+ *   792-793  LFO 2 (global, free-running): Rate, Shape
+ *   794-805  Mod Slots 1–4 (Source, Destination, Amount — see KawaiiModMatrix.h)
+ *   806      Engine Partial Count (read-only output: the count the processor
+ *            runs, or needs at its next activation)
+ *   kNumParams = 807
+ *
+ * Partials 33–128 were added after the original layout shipped, so they live
+ * after the filter section instead of next to partials 1–32. IDs below 172
+ * never move; older saved states simply end early and keep the defaults for
+ * everything appended since.
  */
 
 #pragma once
@@ -37,13 +61,30 @@ namespace Kawaii {
 static const FUID ProcessorUID(0xA1B2C3D4, 0xE5F60718, 0x293A4B5C, 0x6D7E8F90);
 static const FUID ControllerUID(0x09F8E7D6, 0xC5B4A392, 0x81706F5E, 0x4D3C2B1A);
 
-static constexpr int kMaxPartials = 32;
+// Partial counts the voice is compiled for (KawaiiVoice<N>). The processor
+// instantiates the variant selected by kParamPartialCount in setActive().
+static constexpr int kPartialCountOptions[] = { 8, 16, 32, 64, 128 };
+static constexpr int kNumPartialCountOptions = 5;
+static constexpr int kDefaultPartialCountIndex = 2;  // 32 partials
+
+static constexpr int kMaxPartials = 128;  // largest variant — sizes the param layout
 static constexpr int kMaxVoices = 6;
+static constexpr int kNumMidiNotes = 128;  // one tuning param per note
+
+// Mod matrix slots and the offsets within each slot's 3-param block
+static constexpr int kNumModSlots       = 4;
+static constexpr int kModSlotStride     = 3;
+static constexpr int kModSlotOffSource  = 0;
+static constexpr int kModSlotOffDest    = 1;
+static constexpr int kModSlotOffAmount  = 2;
 
 // Per-partial parameter addressing — starts right after the 2 globals
 static constexpr int kPartialParamBase   = 2;
 static constexpr int kPartialParamStride = 5;
 
+// Partials that sit in the original contiguous block (IDs 2–161)
+static constexpr int kNumLegacyPartials = 32;
+
 // Offsets within each partial's 5-param block
 static constexpr int kPartialOffLevel   = 0;
 static constexpr int kPartialOffAttack  = 1;
@@ -51,16 +92,24 @@ static constexpr int kPartialOffDecay   = 2;
 static constexpr int kPartialOffSustain = 3;
 static constexpr int kPartialOffRelease = 4;
 
+// Filter parameter base — starts right after the last legacy partial
+// partialParam(31, 4) = 2 + 31*5 + 4 = 161, so filter starts at 162
+static constexpr int kFilterParamBase = kPartialParamBase + kNumLegacyPartials * kPartialParamStride;
+
+// Partials 33–128 start right after Partial Count (172)
+static constexpr int kExtPartialParamBase = kFilterParamBase + 11;
+static constexpr int kExtPartialParamEnd  =
+    kExtPartialParamBase + (kMaxPartials - kNumLegacyPartials) * kPartialParamStride;
+
 // Helper: get param ID for partial N, offset O
 inline constexpr Vst::ParamID partialParam(int partial, int offset)
 {
-    return static_cast<Vst::ParamID>(kPartialParamBase + partial * kPartialParamStride + offset);
+    if (partial < kNumLegacyPartials)
+        return static_cast<Vst::ParamID>(kPartialParamBase + partial * kPartialParamStride + offset);
+    return static_cast<Vst::ParamID>(
+        kExtPartialParamBase + (partial - kNumLegacyPartials) * kPartialParamStride + offset);
 }
 
-// Filter parameter base — starts right after the last partial
-// partialParam(31, 4) = 2 + 31*5 + 4 = 161, so filter starts at 162
-static constexpr int kFilterParamBase = kPartialParamBase + kMaxPartials * kPartialParamStride;
-
 enum KawaiiParamID : Vst::ParamID
 {
     kParamMasterVolume = 0,
@@ -83,9 +132,63 @@ enum KawaiiParamID : Vst::ParamID
     kParamFilterKeytrk  = kFilterParamBase + 8,  // 170
     kParamFilterSubType = kFilterParamBase + 9,  // 171 (discrete: 0–3, filter variant)
 
-    kNumParams = kFilterParamBase + 10           // 172
+    // Engine section
+    kParamPartialCount  = kFilterParamBase + 10, // 172 (discrete: index into kPartialCountOptions)
+
+    // partialParam(32, 0)=173 ... partialParam(127, 4)=652
+
+    kParamFilterOversample = kExtPartialParamEnd,     // 653 (discrete: Off/2×/4×)
+    kParamFilterSpectral,                             // 654 (discrete: Time Domain/Spectral)
+    kParamPartialRendering,                           // 655 (discrete: Full Rate/Multi-Rate)
+    kParamQuality,                                    // 656 (discrete: Auto, then tiers 0–4)
+    kParamRenderBackend,                              // 657 (read-only: Inline CPU/Offload)
+    kParamMemoryFootprint,                            // 658 (read-only: MB, 0–kMemoryFootprintMaxMB)
+    kParamPitchBend,                                  // 659 (bipolar: 0.5 = no bend)
+    kParamPitchBendRange,                             // 660 (0–kPitchBendRangeMax semitones)
+    kParamTuningBase,                                 // 661 … 788 (tuningParam(note))
+
+    kParamModWheel = kParamTuningBase + kNumMidiNotes, // 789 (0–1; hosts map CC 1 here)
+    kParamLfo1Rate,                                   // 790 (exponential Hz, see ParamRanges)
+    kParamLfo1Shape,                                  // 791 (discrete: LfoShape)
+    kParamLfo2Rate,                                   // 792
+    kParamLfo2Shape,                                  // 793
+    kParamModSlotBase,                                // 794 … 805 (modSlotParam(slot, offset))
+
+    kParamEnginePartialCount = kParamModSlotBase + kNumModSlots * kModSlotStride, // 806 (read-only: as kParamPartialCount)
+
+    kNumParams                                        // 807
 };
 
+// Param ID holding the pitch of MIDI note `note` (see ParamRanges::kTuning*)
+inline constexpr Vst::ParamID tuningParam(int note)
+{
+    return static_cast<Vst::ParamID>(kParamTuningBase + note);
+}
+
+// Param ID of mod matrix slot `slot`, offset kModSlotOff*
+inline constexpr Vst::ParamID modSlotParam(int slot, int offset)
+{
+    return static_cast<Vst::ParamID>(kParamModSlotBase + slot * kModSlotStride + offset);
+}
+
+// Partial count for a normalized kParamPartialCount value
+inline constexpr int partialCountFromNormalized(double normalized)
+{
+    int idx = static_cast<int>(normalized * (kNumPartialCountOptions - 1) + 0.5);
+    idx = idx < 0 ? 0 : (idx >= kNumPartialCountOptions ? kNumPartialCountOptions - 1 : idx);
+    return kPartialCountOptions[idx];
+}
+
+// Normalized kParamPartialCount value for a partial count; the default for
+// counts that are not one of kPartialCountOptions
+inline constexpr double partialCountToNormalized(int count)
+{
+    for (int i = 0; i < kNumPartialCountOptions; i++)
+        if (kPartialCountOptions[i] == count)
+            return static_cast<double>(i) / (kNumPartialCountOptions - 1);
+    return static_cast<double>(kDefaultPartialCountIndex) / (kNumPartialCountOptions - 1);
+}
+
 } // namespace Kawaii
 } // namespace Vst
 } // namespace Steinberg
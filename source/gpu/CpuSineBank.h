@@ -0,0 +1,144 @@
+/**
+ * CpuSineBank.h — CPU stand-in for the offload sine bank
+ *
+ * Runs the Metal kernel's math (per voice, per sample: Σ sin · level · env,
+ * times the voice's velocity scale) on the calling thread, behind the same
+ * double-buffer protocol: processBlock() renders the current block into one
+ * buffer set and returns the other set's — the previous block's — output.
+ * Latency, buffer layouts and the processor's phase bookkeeping are exactly
+ * those of MetalSineBank, so the whole offload path (and backend selection)
+ * can be exercised without a GPU, e.g. in the headless tools on Linux.
+ *
+ * Build with KAWAII_OFFLOAD_CPU_STANDIN to use it as the offload backend.
+ * It is not a performance option: the work still lands on the audio thread.
+ */
+
+#pragma once
+
+#include "SineBankBackend.h"
+#include "../processor/KawaiiPhase.h"
+
+#include <cstring>
+#include <vector>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+class CpuSineBank : public SineBankBackend {
+public:
+    bool init(int maxOscillators, int maxBlockSize, int maxVoices) override
+    {
+        (void)maxOscillators;
+        this->maxBlockSize = maxBlockSize;
+        for (auto& set : sets)
+        {
+            set.output.assign((size_t)maxVoices * (size_t)maxBlockSize, 0.0f);
+            set.numVoices = 0;
+            set.numSamples = 0;
+        }
+        reset();
+        available = true;
+        return true;
+    }
+
+    void processBlock(
+        const OscillatorParams* oscParams,
+        const float* envValues,
+        int numOscillators,
+        int numEnvRows,
+        const VoiceDescriptor* voiceDescs,
+        int numVoices,
+        int numSamples,
+        float* prevOutput,
+        int& outPrevNumVoices,
+        int& outPrevNumSamples
+    ) override
+    {
+        (void)numOscillators;
+        (void)numEnvRows;
+        outPrevNumVoices  = 0;
+        outPrevNumSamples = 0;
+        if (!available) return;
+
+        // Previous block's results
+        if (hasPreviousResult)
+        {
+            const auto& readSet = sets[1 - nextWriteIdx];
+            outPrevNumVoices  = readSet.numVoices;
+            outPrevNumSamples = readSet.numSamples;
+            if (outPrevNumVoices > 0 && outPrevNumSamples > 0)
+                std::memcpy(prevOutput, readSet.output.data(),
+                            (size_t)(outPrevNumVoices * outPrevNumSamples) * sizeof(float));
+        }
+
+        // Current block, rendered now, handed out next call
+        auto& writeSet = sets[nextWriteIdx];
+        writeSet.numVoices  = numVoices;
+        writeSet.numSamples = numSamples;
+        for (int v = 0; v < numVoices; v++)
+        {
+            const VoiceDescriptor& desc = voiceDescs[v];
+            float* out = &writeSet.output[(size_t)(v * numSamples)];
+            for (int s = 0; s < numSamples; s++)
+            {
+                float sum = 0.0f;
+                for (uint32_t i = 0; i < desc.numOsc; i++)
+                {
+                    const OscillatorParams& osc = oscParams[desc.startOsc + i];
+                    float env = envValues[static_cast<size_t>(osc.envRow) * (size_t)numSamples + (size_t)s];
+                    if (env <= 0.0f) continue;
+
+                    uint32_t phase = osc.phaseStart + static_cast<uint32_t>(s) * osc.phaseIncrement;
+                    float level = osc.level + static_cast<float>(s) * osc.levelDelta;
+                    sum += static_cast<float>(FixedPhase::sine(phase)) * level * env;
+                }
+                out[s] = sum * desc.velocityScale;
+            }
+        }
+
+        nextWriteIdx = 1 - nextWriteIdx;
+        hasPreviousResult = true;
+    }
+
+    void reset() override
+    {
+        nextWriteIdx = 0;
+        hasPreviousResult = false;
+    }
+
+    void shutdown() override
+    {
+        for (auto& set : sets)
+            set.output.clear();
+        available = false;
+        hasPreviousResult = false;
+    }
+
+    bool isAvailable() const override { return available; }
+    int getLatencySamples() const override { return available ? maxBlockSize : 0; }
+    const char* getName() const override { return "CPU stand-in"; }
+
+    size_t getMemoryBytes() const override
+    {
+        return (sets[0].output.capacity() + sets[1].output.capacity()) * sizeof(float);
+    }
+
+private:
+    struct BufferSet
+    {
+        std::vector<float> output;   // [voiceIdx * numSamples + sampleIdx]
+        int numVoices = 0;
+        int numSamples = 0;
+    };
+
+    BufferSet sets[2];
+    int nextWriteIdx = 0;
+    bool hasPreviousResult = false;
+    int maxBlockSize = 0;
+    bool available = false;
+};
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
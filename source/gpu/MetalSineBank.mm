@@ -46,10 +46,12 @@ static const char* kSineBankShaderSource = R"metal(
 using namespace metal;
 
 struct OscillatorParams {
-    float phaseStart;
-    float phaseIncrement;
+    uint phaseStart;
+    uint phaseIncrement;
     float level;
-    float velocityScale;
+    float envRow;
+    float levelDelta;
+    float pad0, pad1, pad2;
 };
 
 struct VoiceDescriptor {
@@ -79,15 +81,20 @@ kernel void sineBankPerVoiceKernel(
     float sum = 0.0f;
     for (uint i = 0; i < desc.numOsc; i++) {
         uint oscIdx = desc.startOsc + i;
-        float env = envValues[oscIdx * numSamples + sampleIdx];
+        float env = envValues[uint(oscParams[oscIdx].envRow) * numSamples + sampleIdx];
         if (env <= 0.0f) continue;
 
-        float phase = oscParams[oscIdx].phaseStart
-                    + float(sampleIdx) * oscParams[oscIdx].phaseIncrement;
-        phase = phase - floor(phase);
+        // Fixed-point phase wraps by overflow — exact at any block length.
+        // Read as signed, it is x half-cycles in [-1, 1): sin(2π·phase) = sinpi(x).
+        uint phase = oscParams[oscIdx].phaseStart
+                   + sampleIdx * oscParams[oscIdx].phaseIncrement;
+        float x = float(as_type<int>(phase)) * (1.0f / 2147483648.0f);
+
+        float level = oscParams[oscIdx].level
+                    + float(sampleIdx) * oscParams[oscIdx].levelDelta;
 
-        sum += metal::sin(2.0f * M_PI_F * phase)
-             * oscParams[oscIdx].level
+        sum += metal::sinpi(x)
+             * level
              * env;
     }
 
@@ -231,6 +238,7 @@ void MetalSineBank::processBlock(
     const OscillatorParams* oscParams,
     const float* envValues,
     int numOscillators,
+    int numEnvRows,
     const VoiceDescriptor* voiceDescs,
     int numVoices,
     int numSamples,
@@ -311,7 +319,7 @@ void MetalSineBank::processBlock(
         memcpy(writeSet.oscParamsBuf.contents, oscParams,
                (size_t)numOscillators * sizeof(OscillatorParams));
         memcpy(writeSet.envValuesBuf.contents, envValues,
-               (size_t)numOscillators * numSamples * sizeof(float));
+               (size_t)numEnvRows * numSamples * sizeof(float));
         memcpy(writeSet.voiceDescsBuf.contents, voiceDescs,
                (size_t)numVoices * sizeof(VoiceDescriptor));
 
@@ -363,6 +371,27 @@ void MetalSineBank::processBlock(
     _impl->hasPreviousResult = true;
 }
 
+void MetalSineBank::reset()
+{
+    if (!_impl || !_impl->available) return;
+
+    // Wait for everything queued so far, then start over with no previous result
+    @autoreleasepool {
+        id<MTLCommandBuffer> fence = [_impl->commandQueue commandBuffer];
+        [fence commit];
+        [fence waitUntilCompleted];
+    }
+
+    for (auto& set : _impl->sets)
+    {
+        set.gpuDone.store(false);
+        set.numVoices = 0;
+        set.numSamples = 0;
+    }
+    _impl->nextWriteIdx = 0;
+    _impl->hasPreviousResult = false;
+}
+
 void MetalSineBank::shutdown()
 {
     if (!_impl || !_impl->available) return;
@@ -402,6 +431,19 @@ int MetalSineBank::getLatencySamples() const
     return _impl->maxBlockSize;  // one buffer of latency from double buffering
 }
 
+size_t MetalSineBank::getMemoryBytes() const
+{
+    if (!_impl) return 0;
+    size_t bytes = 0;
+    for (const auto& set : _impl->sets)
+    {
+        // nil after shutdown — [nil length] is 0
+        bytes += (size_t)[set.oscParamsBuf length] + (size_t)[set.envValuesBuf length]
+               + (size_t)[set.outputBuf length] + (size_t)[set.voiceDescsBuf length];
+    }
+    return bytes;
+}
+
 }}} // namespaces
 
 #endif // __APPLE__
@@ -0,0 +1,98 @@
+/**
+ * SineBankBackend.h — Interface for offloaded (double-buffered) sine banks
+ *
+ * An offload backend renders the oscillator bank away from the audio
+ * thread's inline path: processBlock() submits the current block and hands
+ * back the PREVIOUS block's per-voice output, so the processor runs one
+ * block behind and reports that as latency.
+ *
+ * Implementations:
+ *   MetalSineBank — Metal compute on Apple GPUs (the production backend)
+ *   CpuSineBank   — same kernel and protocol on the CPU; a stand-in for
+ *                   testing the offload path and backend selection anywhere
+ *                   (KAWAII_OFFLOAD_CPU_STANDIN)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+// Per-oscillator data sent to the backend each block (32 bytes, naturally aligned)
+struct OscillatorParams {
+    uint32_t phaseStart;    // Current phase, fixed point (2^32 = one cycle)
+    uint32_t phaseIncrement;// Per-sample phase increment, fixed point
+    float level;            // Partial level at the block's first sample
+    float envRow;           // Row in envValues (partials sharing an ADSR share a row)
+    float levelDelta;       // Per-sample level ramp (spectral filter gain changes)
+    float pad[3];           // Padding to 32 bytes
+};
+
+// Per-voice metadata for the per-voice kernel (16 bytes, aligned).
+// Tells the kernel which oscillators belong to each voice, so it can
+// sum per-voice instead of globally.
+struct VoiceDescriptor {
+    uint32_t startOsc;      // First oscillator index in oscParams/envValues
+    uint32_t numOsc;        // Number of active oscillators for this voice
+    float velocityScale;    // velocity / partial count (applied once after sum)
+    float pad;              // Padding to 16-byte alignment
+};
+
+class SineBankBackend {
+public:
+    virtual ~SineBankBackend() = default;
+
+    // Call from setActive(true). Returns false if the backend is unavailable.
+    virtual bool init(int maxOscillators, int maxBlockSize, int maxVoices) = 0;
+
+    // Async double-buffered dispatch.
+    // Submits current block's data (non-blocking) AND returns the PREVIOUS
+    // block's results. On first call, previous output is zeroed.
+    //
+    // oscParams: oscillators grouped by voice
+    // envValues layout: [envRow * numSamples + sampleIdx], numEnvRows rows;
+    //   each oscillator reads the row named by its envRow
+    //   (numEnvRows ≤ numOscillators)
+    // voiceDescs: each voice's oscillator range
+    //
+    // prevOutput: receives PREVIOUS block's per-voice output
+    //             layout: [voiceIdx * prevNumSamples + sampleIdx]
+    // outPrevNumVoices/outPrevNumSamples: dimensions of previous output
+    virtual void processBlock(
+        const OscillatorParams* oscParams,
+        const float* envValues,
+        int numOscillators,
+        int numEnvRows,
+        const VoiceDescriptor* voiceDescs,
+        int numVoices,
+        int numSamples,
+        float* prevOutput,
+        int& outPrevNumVoices,
+        int& outPrevNumSamples
+    ) = 0;
+
+    // Wait for in-flight work and forget the previous result, so the next
+    // processBlock() starts a fresh pipeline. Blocks — not for process().
+    virtual void reset() = 0;
+
+    // Call from setActive(false). Drains in-flight work before releasing.
+    virtual void shutdown() = 0;
+
+    virtual bool isAvailable() const = 0;
+
+    // Latency introduced by double buffering (= maxBlockSize samples)
+    virtual int getLatencySamples() const = 0;
+
+    virtual const char* getName() const = 0;
+
+    // Bytes of the backend's own buffers (both sets), for memory accounting
+    virtual size_t getMemoryBytes() const = 0;
+};
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
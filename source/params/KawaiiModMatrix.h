@@ -0,0 +1,82 @@
+/**
+ * KawaiiModMatrix.h — Modulation sources, destinations and LFO shapes
+ *
+ * The mod matrix is kNumModSlots slots (KawaiiCids.h), each routing one
+ * source to one destination with a bipolar amount. Every source stays in
+ * [-1, 1], so a slot moves its destination by at most amount × that
+ * destination's depth (ParamRanges::kMod*). Slots on the same destination
+ * add up.
+ *
+ * The processor evaluates the matrix in its modulation engine
+ * (processor/KawaiiModulation.h); the controller lists the names below.
+ */
+
+#pragma once
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+enum ModSource : int
+{
+    kModSourceOff = 0,
+    kModSourceLfo1,       // per voice, restarts at note-on (bipolar)
+    kModSourceLfo2,       // global, free-running (bipolar)
+    kModSourceVelocity,   // 0–1
+    kModSourceNote,       // tuned pitch: (pitch − 60) / 60, clamped to −1…1
+    kModSourceModWheel,   // 0–1 (kParamModWheel)
+    kNumModSources
+};
+
+enum ModDestination : int
+{
+    kModDestCutoff = 0,   // octaves (filter and spectral filter alike)
+    kModDestResonance,    // added to Filter Reso
+    kModDestLevel,        // gain on all partial levels, ramped per sample
+    kModDestPitch,        // semitones, on top of bend and Master Tune
+    kNumModDestinations
+};
+
+enum LfoShape : int
+{
+    kLfoSine = 0,
+    kLfoTriangle,
+    kLfoSaw,
+    kLfoSquare,
+    kNumLfoShapes
+};
+
+inline const char* modSourceName(int source)
+{
+    static constexpr const char* kNames[kNumModSources] = {
+        "Off", "LFO 1", "LFO 2", "Velocity", "Note", "Mod Wheel",
+    };
+    return (source >= 0 && source < kNumModSources) ? kNames[source] : "?";
+}
+
+inline const char* modDestinationName(int destination)
+{
+    static constexpr const char* kNames[kNumModDestinations] = {
+        "Cutoff", "Resonance", "Partial Levels", "Pitch",
+    };
+    return (destination >= 0 && destination < kNumModDestinations) ? kNames[destination] : "?";
+}
+
+inline const char* lfoShapeName(int shape)
+{
+    static constexpr const char* kNames[kNumLfoShapes] = {
+        "Sine", "Triangle", "Saw", "Square",
+    };
+    return (shape >= 0 && shape < kNumLfoShapes) ? kNames[shape] : "?";
+}
+
+// Entry of a `count`-entry list param for a normalized value
+inline constexpr int listIndexFromNormalized(double normalized, int count)
+{
+    int idx = static_cast<int>(normalized * (count - 1) + 0.5);
+    return idx < 0 ? 0 : (idx >= count ? count - 1 : idx);
+}
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
@@ -135,6 +135,47 @@ namespace ParamRanges
     // --- Filter keytrack ---
     // 0 = no tracking, 1 = full tracking (100 Hz/semitone from C3)
     constexpr double kFilterKeytrackDefault = 0.0;
+
+    // --- Pitch ---
+    // Master Tune: bipolar, 0.5 = A4 at 440 Hz, ends at ±100 cents.
+    // Pitch Bend: bipolar, 0.5 = none, ends at ±(Pitch Bend Range).
+    constexpr double kMasterTuneCents   = 100.0;
+    constexpr double kPitchBendRangeMax = 24.0;   // semitones
+    constexpr double kPitchBendRangeDefault = 2.0;
+
+    // --- Tuning table ---
+    // Each MIDI note's pitch in semitones (69 = A4 before Master Tune),
+    // linear over [kTuningPitchMin, kTuningPitchMin + kTuningPitchSpan).
+    // The span is a power of two, so 12-TET defaults are exact in a float
+    // state and a 24-bit mantissa still resolves ~0.001 cent.
+    constexpr double kTuningPitchMin  = -64.0;
+    constexpr double kTuningPitchSpan = 256.0;
+
+    inline constexpr double tuningPitchToNormalized(double pitch)
+    {
+        return (pitch - kTuningPitchMin) / kTuningPitchSpan;
+    }
+
+    inline constexpr double normalizedToTuningPitch(double normalized)
+    {
+        return kTuningPitchMin + normalized * kTuningPitchSpan;
+    }
+
+    // --- Modulation ---
+    // LFO rate: exponential, knob at 0 = 0.02 Hz, knob at 1 = 20 Hz (2/3 = 2 Hz).
+    // Mod slot amounts are bipolar (0.5 = none); at full amount a source at
+    // ±1 moves cutoff ±kModCutoffOctaves, pitch ±kModPitchSemitones,
+    // resonance ±1 and the partial levels by a gain of 1 ± 1.
+    constexpr double kLfoRateMinHz  = 0.02;
+    constexpr double kLfoRateMaxHz  = 20.0;
+    constexpr double kLfoRateDefault = 2.0 / 3.0;
+    constexpr double kModCutoffOctaves  = 4.0;
+    constexpr double kModPitchSemitones = 12.0;
+
+    // --- Memory footprint (read-only output) ---
+    // Linear 0–256 MB; an instance at 128 partials and 8192-sample blocks
+    // stays well below the top
+    constexpr double kMemoryFootprintMaxMB = 256.0;
 }
 
 } // namespace Kawaii
@@ -0,0 +1,177 @@
+/**
+ * KawaiiTuning.h — Scala scales → the per-note tuning table
+ * ==========================================================
+ *
+ * The processor reads every note's pitch from the tuning params
+ * (tuningParam(0…127), see KawaiiCids.h) at note-on, so any tuning is just
+ * 128 pitches. This file builds them from a Scala scale:
+ *
+ *   ! comment lines start with '!'
+ *   description line
+ *   number of degrees
+ *   one pitch per degree — cents if it contains a '.', otherwise a ratio
+ *   ("3/2") or a whole number ("2"); the last degree is the period
+ *
+ * and a linear keyboard mapping (what a Scala .kbm of size 0 describes):
+ * middleNote plays degree 0, consecutive keys play consecutive degrees, and
+ * referenceNote sounds at referenceHz.
+ *
+ * Not realtime-safe (strings, parsing) — use it in tools (kawaii_render
+ * --scl) and store the pitches in a state; the plugin itself loads tuning
+ * tables from state only (the tuning params are hidden).
+ */
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "../entry/KawaiiCids.h"
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+struct ScalaScale
+{
+    std::string description;
+    std::vector<double> cents;   // degrees 1…n; cents.back() is the period
+};
+
+struct KeyboardMapping
+{
+    int    middleNote    = 60;      // plays degree 0
+    int    referenceNote = 69;
+    double referenceHz   = 440.0;
+};
+
+/**
+ * Parse the text of a .scl file. Returns false (with a message in *error,
+ * if given) when the text is not a valid scale.
+ */
+inline bool parseScala(const std::string& text, ScalaScale& scale, std::string* error = nullptr)
+{
+    auto fail = [error](const std::string& message) {
+        if (error)
+            *error = message;
+        return false;
+    };
+
+    scale = ScalaScale();
+    int count = -1;
+    bool haveDescription = false;
+
+    size_t pos = 0;
+    while (pos <= text.size())
+    {
+        size_t end = text.find('\n', pos);
+        if (end == std::string::npos)
+            end = text.size();
+        std::string line = text.substr(pos, end - pos);
+        pos = end + 1;
+
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (!line.empty() && line[0] == '!')
+            continue;
+
+        // The description may be empty, so it is taken verbatim
+        if (!haveDescription)
+        {
+            scale.description = line;
+            haveDescription = true;
+            continue;
+        }
+
+        size_t first = line.find_first_not_of(" \t");
+        if (first == std::string::npos)
+            continue;
+        const char* p = line.c_str() + first;
+
+        if (count < 0)
+        {
+            char* after = nullptr;
+            long n = strtol(p, &after, 10);
+            if (after == p || n < 1)
+                return fail("bad degree count: " + line);
+            count = static_cast<int>(n);
+            continue;
+        }
+
+        // Anything after the value (a name, a comment) is ignored
+        double c;
+        char* after = nullptr;
+        std::string token(p, line.c_str() + line.size());
+        token = token.substr(0, token.find_first_of(" \t"));
+        if (token.find('.') != std::string::npos)
+        {
+            c = strtod(token.c_str(), &after);
+            if (after == token.c_str())
+                return fail("bad pitch: " + line);
+        }
+        else
+        {
+            long num = strtol(token.c_str(), &after, 10);
+            long den = 1;
+            if (after == token.c_str())
+                return fail("bad pitch: " + line);
+            if (*after == '/')
+            {
+                const char* d = after + 1;
+                den = strtol(d, &after, 10);
+                if (after == d)
+                    return fail("bad pitch: " + line);
+            }
+            if (num <= 0 || den <= 0)
+                return fail("ratio must be positive: " + line);
+            c = 1200.0 * std::log2(static_cast<double>(num) / static_cast<double>(den));
+        }
+
+        scale.cents.push_back(c);
+        if (static_cast<int>(scale.cents.size()) == count)
+            break;
+    }
+
+    if (count < 0)
+        return fail("missing degree count");
+    if (static_cast<int>(scale.cents.size()) != count)
+        return fail("expected " + std::to_string(count) + " pitches, found "
+                    + std::to_string(scale.cents.size()));
+    return true;
+}
+
+/**
+ * Pitch of every MIDI note (semitones, 69 = A4 at 440 Hz) for a scale under
+ * a linear keyboard mapping — the values for tuningParam(n), before
+ * ParamRanges::tuningPitchToNormalized.
+ */
+inline std::array<double, kNumMidiNotes> scalaNotePitches(const ScalaScale& scale,
+                                                          const KeyboardMapping& map = {})
+{
+    const int size = static_cast<int>(scale.cents.size());
+    const double period = size > 0 ? scale.cents.back() : 1200.0;
+
+    // Cents of note n above middleNote
+    auto centsOf = [&](int note) {
+        if (size == 0)
+            return (note - map.middleNote) * 100.0;
+        int steps = note - map.middleNote;
+        int octave = steps >= 0 ? steps / size : -((-steps + size - 1) / size);
+        int degree = steps - octave * size;
+        return octave * period + (degree > 0 ? scale.cents[(size_t)degree - 1] : 0.0);
+    };
+
+    const double referencePitch = 69.0 + 12.0 * std::log2(map.referenceHz / 440.0);
+    const double referenceCents = centsOf(map.referenceNote);
+
+    std::array<double, kNumMidiNotes> pitches;
+    for (int n = 0; n < kNumMidiNotes; n++)
+        pitches[(size_t)n] = referencePitch + (centsOf(n) - referenceCents) / 100.0;
+    return pitches;
+}
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
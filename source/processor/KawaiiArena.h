@@ -0,0 +1,118 @@
+/**
+ * KawaiiArena.h — Per-instance render buffer arena
+ *
+ * One aligned allocation holds every render buffer the processor needs
+ * (GPU staging, per-voice output, mix bus, filter delay lines). Regions are
+ * carved with a bump pointer, each starting on a cache line, so the whole
+ * working set is contiguous and its footprint is known up front.
+ *
+ * Layout is written once and run twice: first in measure mode (beginMeasure
+ * … measuredBytes(), carve() returns nullptr and only counts), then for real
+ * after reserve(). The processor reserves in setupProcessing() and carves in
+ * setActive(); seal() then forbids any further carving or reserving until the
+ * processor deactivates — asserted in debug builds, so a buffer added later
+ * cannot quietly allocate while audio is running.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+class RenderArena
+{
+public:
+    static constexpr size_t kAlignment = 64;   // cache line
+
+    static constexpr size_t alignUp(size_t bytes)
+    {
+        return (bytes + kAlignment - 1) & ~(kAlignment - 1);
+    }
+
+    // --- Measure pass ---
+    void beginMeasure()
+    {
+        assert(!sealed && "RenderArena: layout changed after activation");
+        measuring = true;
+        used = 0;
+    }
+
+    size_t measuredBytes()
+    {
+        measuring = false;
+        return used;
+    }
+
+    // Make room for at least `bytes` and drop all regions. Keeps the current
+    // block if it is already big enough. Not realtime-safe.
+    void reserve(size_t bytes)
+    {
+        assert(!sealed && "RenderArena: allocation after activation");
+        used = 0;
+        if (bytes <= capacity)
+            return;
+
+        block.reset(static_cast<std::byte*>(
+            ::operator new[](alignUp(bytes), std::align_val_t(kAlignment))));
+        capacity = alignUp(bytes);
+    }
+
+    void release()
+    {
+        assert(!sealed && "RenderArena: release while active");
+        block.reset();
+        capacity = used = 0;
+    }
+
+    // Next cache-line-aligned region of `count` zeroed Ts (nullptr in the
+    // measure pass). T must be trivially constructible.
+    template <typename T>
+    T* carve(size_t count)
+    {
+        assert(!sealed && "RenderArena: allocation after activation");
+        size_t bytes = alignUp(count * sizeof(T));
+        size_t offset = used;
+        used += bytes;
+
+        if (measuring)
+            return nullptr;
+
+        assert(used <= capacity && "RenderArena: layout exceeds reservation");
+        if (used > capacity)
+            return nullptr;
+
+        std::byte* p = block.get() + offset;
+        std::memset(p, 0, bytes);
+        return reinterpret_cast<T*>(p);
+    }
+
+    // Freeze the layout while the processor is active
+    void seal()   { sealed = true; }
+    void unseal() { sealed = false; }
+
+    size_t getCapacity() const { return capacity; }
+    size_t getUsed() const { return used; }
+
+private:
+    struct AlignedDelete
+    {
+        void operator()(std::byte* p) const { ::operator delete[](p, std::align_val_t(kAlignment)); }
+    };
+
+    std::unique_ptr<std::byte[], AlignedDelete> block;
+    size_t capacity = 0;
+    size_t used = 0;
+    bool measuring = false;
+    bool sealed = false;
+};
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
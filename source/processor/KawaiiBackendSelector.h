@@ -0,0 +1,112 @@
+/**
+ * KawaiiBackendSelector.h — Inline CPU vs. offload rendering, per workload
+ *
+ * setActive() benchmarks both render paths on the real voice bank (so the
+ * partial count, filter, wavetable collapse and quality settings of this
+ * activation are all priced in) with one voice and with every voice, and
+ * fits a per-block cost of audio-thread time for V voices in B samples:
+ *
+ *   cost(V, B) = fixed + V·B·perVoiceSample
+ *
+ * The offload path's fixed part is its submit/readback overhead; inline has
+ * next to none. Offload must also get its results back well inside a block
+ * (round trip ≤ kRoundTripBudget of the benchmark block), or it is out.
+ *
+ * Offload costs one block of latency and a host restart to report it, so
+ * switching to it needs a clear win (kOffloadAdvantage) while staying on it
+ * only needs a tie. The workload is the last busy period's peak voice count
+ * and smallest block; the processor re-evaluates when it goes idle, where
+ * nothing is in flight and switching drops nothing.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <climits>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+struct PathCost
+{
+    double fixed = 0.0;            // seconds per block
+    double perVoiceSample = 0.0;   // seconds per voice per sample
+
+    double at(int voices, int blockSize) const
+    {
+        return fixed + static_cast<double>(voices) * blockSize * perVoiceSample;
+    }
+
+    // Fit from per-block times for one voice and for maxVoices voices
+    static PathCost fit(double oneVoice, double allVoices, int maxVoices, int blockSize)
+    {
+        PathCost c;
+        double perVoice = std::max(0.0, (allVoices - oneVoice) / (maxVoices - 1));
+        c.perVoiceSample = perVoice / blockSize;
+        c.fixed = std::max(0.0, oneVoice - perVoice);
+        return c;
+    }
+};
+
+class BackendSelector
+{
+public:
+    static constexpr double kOffloadAdvantage = 1.5;
+    static constexpr double kRoundTripBudget  = 0.8;   // of the block duration
+
+    struct Workload
+    {
+        int voices = 0;
+        int blockSize = 0;
+    };
+
+    void setCosts(const PathCost& inlineCost, const PathCost& offloadCost, bool offloadViable)
+    {
+        inlinePath = inlineCost;
+        offloadPath = offloadCost;
+        viable = offloadViable;
+    }
+
+    // True to render the workload via the offload backend; offloadNow is the
+    // path currently in use (hysteresis)
+    bool preferOffload(bool offloadNow, const Workload& w) const
+    {
+        if (!viable)
+            return false;
+        if (w.voices <= 0 || w.blockSize <= 0)
+            return offloadNow;
+
+        double inlineCost = inlinePath.at(w.voices, w.blockSize);
+        double offloadCost = offloadPath.at(w.voices, w.blockSize);
+        return offloadNow ? offloadCost <= inlineCost
+                          : offloadCost * kOffloadAdvantage < inlineCost;
+    }
+
+    // Busy blocks: track the peak voice count and the smallest block
+    void observe(int activeVoices, int blockSize)
+    {
+        busy.voices = std::max(busy.voices, activeVoices);
+        busy.blockSize = std::min(busy.blockSize, blockSize);
+    }
+
+    // The busy period's workload (voices = 0 if there was none); starts a new one
+    Workload takeWorkload()
+    {
+        Workload w = busy;
+        if (w.voices == 0)
+            w.blockSize = 0;
+        busy = { 0, INT_MAX };
+        return w;
+    }
+
+private:
+    PathCost inlinePath;
+    PathCost offloadPath;
+    bool viable = false;
+    Workload busy { 0, INT_MAX };
+};
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
@@ -0,0 +1,243 @@
+/**
+ * KawaiiHalfBand.h — Polyphase IIR half-band resamplers for filter oversampling
+ *
+ * 2× up/down conversion with a two-path polyphase allpass half-band (the
+ * structure popularised by Laurent de Soras' HIIR and used by Surge's
+ * HalfRateFilter). Each path is a chain of first-order allpass sections
+ * running at the LOW rate, so a 2× stage costs NC multiplies per input
+ * sample. The two paths are processed in lockstep as a pair, which the
+ * compiler packs into one 2-lane vector op per section.
+ *
+ * 4× is two cascaded 2× stages: a steep stage at 2× and a cheap stage
+ * at 4× (its transition band only has to clear the already-filtered image).
+ *
+ * Coefficients come from the elliptic half-band design (HIIR's
+ * PolyphaseIir2Designer), computed once per coefficient count.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <array>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+namespace HalfBandDesign
+{
+    // Elliptic half-band allpass coefficients for NC sections.
+    // transition: transition bandwidth normalized to the HIGH rate (0–0.5).
+    template <int NC>
+    std::array<float, NC> computeCoefs(double transition)
+    {
+        // Transition parameters (k: selectivity, q: nome)
+        double k = std::tan((1.0 - transition * 2.0) * M_PI / 4.0);
+        k *= k;
+        double kksqrt = std::pow(1.0 - k * k, 0.25);
+        double e = 0.5 * (1.0 - kksqrt) / (1.0 + kksqrt);
+        double e2 = e * e;
+        double e4 = e2 * e2;
+        double q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+
+        const int order = NC * 2 + 1;
+        std::array<float, NC> coefs {};
+
+        for (int index = 0; index < NC; index++)
+        {
+            const int c = index + 1;
+
+            double num = 0.0;
+            {
+                int i = 0, j = 1;
+                double term;
+                do {
+                    term = std::pow(q, i * (i + 1)) * std::sin((i * 2 + 1) * c * M_PI / order) * j;
+                    num += term;
+                    j = -j;
+                    i++;
+                } while (std::abs(term) > 1e-100);
+            }
+            num *= std::pow(q, 0.25);
+
+            double den = 0.5;
+            {
+                int i = 1, j = -1;
+                double term;
+                do {
+                    term = std::pow(q, i * i) * std::cos(i * 2 * c * M_PI / order) * j;
+                    den += term;
+                    j = -j;
+                    i++;
+                } while (std::abs(term) > 1e-100);
+            }
+
+            double ww = num / den;
+            double wwsq = ww * ww;
+            double x = std::sqrt((1.0 - wwsq * k) * (1.0 - wwsq / k)) / (1.0 + wwsq);
+            coefs[(size_t)index] = static_cast<float>((1.0 - x) / (1.0 + x));
+        }
+        return coefs;
+    }
+
+    // Shared coefficient tables — designed once, read-only afterwards
+    inline const std::array<float, 10>& steepCoefs()
+    {
+        static const auto c = computeCoefs<10>(0.04);   // passband to 0.42·fs(base)
+        return c;
+    }
+
+    inline const std::array<float, 4>& relaxedCoefs()
+    {
+        static const auto c = computeCoefs<4>(0.12);
+        return c;
+    }
+}
+
+// Allpass ladder state shared by the up- and downsampler. Sections alternate
+// between the two polyphase paths: even index → path 0, odd → path 1.
+template <int NC>
+struct HalfBandPaths
+{
+    static_assert(NC % 2 == 0, "sections come in path pairs");
+
+    const float* coef = nullptr;
+    float x[NC] = {};
+    float y[NC] = {};
+
+    void reset()
+    {
+        for (int i = 0; i < NC; i++) { x[i] = 0.0f; y[i] = 0.0f; }
+    }
+
+    // Run one low-rate sample through both paths (in lockstep)
+    inline void run(float& path0, float& path1)
+    {
+        for (int i = 0; i < NC; i += 2)
+        {
+            float t0 = (path0 - y[i])     * coef[i]     + x[i];
+            float t1 = (path1 - y[i + 1]) * coef[i + 1] + x[i + 1];
+            x[i] = path0;     x[i + 1] = path1;
+            y[i] = t0;        y[i + 1] = t1;
+            path0 = t0;       path1 = t1;
+        }
+    }
+};
+
+template <int NC>
+class HalfBandUpsampler
+{
+public:
+    explicit HalfBandUpsampler(const float* coefs) { paths.coef = coefs; }
+
+    void reset() { paths.reset(); }
+
+    // in: n samples → out: 2n samples
+    void process(const float* in, float* out, int n)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            float even = in[i], odd = in[i];
+            paths.run(even, odd);
+            out[2 * i]     = even;
+            out[2 * i + 1] = odd;
+        }
+    }
+
+private:
+    HalfBandPaths<NC> paths;
+};
+
+template <int NC>
+class HalfBandDownsampler
+{
+public:
+    explicit HalfBandDownsampler(const float* coefs) { paths.coef = coefs; }
+
+    void reset() { paths.reset(); }
+
+    // in: 2n samples → out: n samples (in-place safe: out may alias in)
+    void process(const float* in, float* out, int n)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            float p0 = in[2 * i + 1], p1 = in[2 * i];
+            paths.run(p0, p1);
+            out[i] = 0.5f * (p0 + p1);
+        }
+    }
+
+private:
+    HalfBandPaths<NC> paths;
+};
+
+// ============================================================================
+// FilterOversampler — 1×/2×/4× wrapper around a per-block filter callback
+//
+// Holds the resampler state for one voice. process() upsamples a sub-block
+// (≤ kMaxIn samples), hands the high-rate buffer to the filter, and
+// downsamples back in place.
+// ============================================================================
+
+template <int kMaxIn>
+class FilterOversampler
+{
+public:
+    FilterOversampler()
+        : up1(HalfBandDesign::steepCoefs().data())
+        , down1(HalfBandDesign::steepCoefs().data())
+        , up2(HalfBandDesign::relaxedCoefs().data())
+        , down2(HalfBandDesign::relaxedCoefs().data())
+    {}
+
+    void setFactor(int f)
+    {
+        factor = (f >= 4) ? 4 : (f >= 2 ? 2 : 1);
+        reset();
+    }
+
+    int getFactor() const { return factor; }
+
+    void reset()
+    {
+        up1.reset(); down1.reset();
+        up2.reset(); down2.reset();
+    }
+
+    template <typename FilterFn>
+    void process(float* io, int n, FilterFn&& filterFn)
+    {
+        if (factor == 1)
+        {
+            filterFn(io, n);
+            return;
+        }
+
+        up1.process(io, bufA, n);
+        if (factor == 2)
+        {
+            filterFn(bufA, n * 2);
+            down1.process(bufA, io, n);
+            return;
+        }
+
+        up2.process(bufA, bufB, n * 2);
+        filterFn(bufB, n * 4);
+        down2.process(bufB, bufA, n * 2);
+        down1.process(bufA, io, n);
+    }
+
+private:
+    int factor = 1;
+    HalfBandUpsampler<10>   up1;
+    HalfBandDownsampler<10> down1;
+    HalfBandUpsampler<4>    up2;
+    HalfBandDownsampler<4>  down2;
+
+    alignas(16) float bufA[kMaxIn * 2];
+    alignas(16) float bufB[kMaxIn * 4];
+};
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
@@ -0,0 +1,109 @@
+/**
+ * KawaiiKernelBodies.h — Kernel loops, compiled once per ISA level
+ *
+ * Not a normal header: each KawaiiKernels*.cpp includes it inside its own
+ * anonymous namespace, after KawaiiKernels.h and KawaiiPhase.h, with that
+ * file's ISA flags. Everything defined here therefore has internal linkage,
+ * so the linker can never hand one ISA's copy to another.
+ *
+ * For the same reason the loops may only call functions with internal
+ * linkage (FixedPhase is static for this) or compiler builtins — no
+ * std::min/max/fabs, whose out-of-line copies would be shared.
+ */
+
+template <bool Spectral, bool Fast>
+void partialKernel(double* __restrict acc, int n, uint32_t phase0, uint32_t inc,
+                   double level, double gain0, double dGain)
+{
+    for (int s = 0; s < n; s++)
+    {
+        uint32_t ph = phase0 + static_cast<uint32_t>(s) * inc;
+        double sine = Fast ? FixedPhase::sineFast(ph) : FixedPhase::sine(ph);
+        if constexpr (Spectral)
+            acc[s] += sine * level * (gain0 + s * dGain);
+        else
+            acc[s] += sine * level;
+    }
+}
+
+void applyEnvelopeKernel(double* __restrict sum, const double* __restrict groupSum,
+                         const double* __restrict env, int n)
+{
+    for (int s = 0; s < n; s++)
+        sum[s] += groupSum[s] * env[s];
+}
+
+// Jobs run in list order, so each group's sums round the same however the
+// groups are batched
+template <bool Spectral, bool Fast>
+void partialGroupsKernel(double* __restrict sum, double* __restrict lowSum, int n, int numLow, int lowPos0,
+                         const PartialJob* __restrict jobs, const PartialGroup* __restrict groups, int numGroups)
+{
+    for (int g = 0; g < numGroups; g++)
+    {
+        const PartialGroup& group = groups[g];
+        double groupSum[kMaxPartialSegment] = {};
+        double groupLow[kMaxPartialSegment] = {};
+
+        const PartialJob* job = jobs + group.firstJob;
+        for (int j = 0; j < group.numLowJobs; j++, job++)
+            partialKernel<Spectral, Fast>(groupLow, numLow, job->phase0, job->inc, job->level, job->gain0, job->dGain);
+        for (int j = 0; j < group.numFullJobs; j++, job++)
+            partialKernel<Spectral, Fast>(groupSum, n, job->phase0, job->inc, job->level, job->gain0, job->dGain);
+
+        applyEnvelopeKernel(sum, groupSum, group.env, n);
+        for (int j = 0; j < numLow; j++)
+            lowSum[j] += groupLow[j] * group.env[lowPos0 + 2 * j];
+    }
+}
+
+// With dScale = 0 every factor is exactly scale0, so an unmodulated voice
+// packs bit-identical to a plain scale
+void packScaledKernel(float* __restrict dst, const double* __restrict src, int n,
+                      double scale0, double dScale)
+{
+    for (int s = 0; s < n; s++)
+        dst[s] = static_cast<float>(src[s] * (scale0 + s * dScale));
+}
+
+void accumulateKernel(float* __restrict dst, const float* __restrict src, int n)
+{
+    for (int i = 0; i < n; i++)
+        dst[i] += src[i];
+}
+
+// y = sign(x) · (min(|x|, t) + k·o / (k + o)),  o = max(|x| − t, 0), k = 1 − t
+void limitKernel(float* __restrict dst, const float* __restrict src, int n, float gain, float knee)
+{
+    const float t = knee;
+    const float k = 1.0f - knee;
+    for (int i = 0; i < n; i++)
+    {
+        float x = src[i] * gain;
+        float a = x < 0.0f ? -x : x;
+        float over = a > t ? a - t : 0.0f;
+        float y = (a < t ? a : t) + k * over / (k + over);
+        dst[i] = x < 0.0f ? -y : y;
+    }
+}
+
+// Fixed-point multiply, wrapping like the phases; audible ≤ n keeps every
+// product below Nyquist (2^31)
+void harmonicIncrementsKernel(uint32_t* __restrict inc, int n, uint32_t fundamental, int audible)
+{
+    for (int k = 0; k < n; k++)
+        inc[k] = k < audible ? static_cast<uint32_t>(k + 1) * fundamental : 0u;
+}
+
+constexpr KernelTable makeKernelTable(const char* isa)
+{
+    return {
+        isa,
+        { { &partialGroupsKernel<false, false>, &partialGroupsKernel<false, true> },
+          { &partialGroupsKernel<true, false>,  &partialGroupsKernel<true, true> } },
+        &packScaledKernel,
+        &accumulateKernel,
+        &limitKernel,
+        &harmonicIncrementsKernel,
+    };
+}
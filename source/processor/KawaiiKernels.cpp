@@ -0,0 +1,64 @@
+/**
+ * KawaiiKernels.cpp — Baseline kernels + runtime ISA selection
+ */
+
+#include "KawaiiKernels.h"
+#include "KawaiiPhase.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+namespace {
+#include "KawaiiKernelBodies.h"
+
+#if defined(__aarch64__) || defined(__ARM_NEON)
+constexpr KernelTable kBaseline = makeKernelTable("neon");
+#else
+constexpr KernelTable kBaseline = makeKernelTable("sse2");
+#endif
+} // namespace
+
+#if KAWAII_KERNELS_X86
+const KernelTable& kernelsAvx2();     // KawaiiKernelsAvx2.cpp
+const KernelTable& kernelsAvx512();   // KawaiiKernelsAvx512.cpp
+#endif
+
+namespace {
+
+// Widest table the CPU (and OS) supports. $KAWAII_KERNELS=sse2 or avx2
+// caps the level; any other value leaves it to the CPU.
+const KernelTable& selectKernels()
+{
+#if KAWAII_KERNELS_X86
+    const char* cap = getenv("KAWAII_KERNELS");
+    int maxLevel = 2;
+    if (cap && strcmp(cap, "sse2") == 0)
+        maxLevel = 0;
+    else if (cap && strcmp(cap, "avx2") == 0)
+        maxLevel = 1;
+
+    __builtin_cpu_init();
+    if (maxLevel >= 2 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")
+        && __builtin_cpu_supports("avx512vl"))
+        return kernelsAvx512();
+    if (maxLevel >= 1 && __builtin_cpu_supports("avx2"))
+        return kernelsAvx2();
+#endif
+    return kBaseline;
+}
+
+} // namespace
+
+const KernelTable& activeKernels()
+{
+    static const KernelTable& table = selectKernels();
+    return table;
+}
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
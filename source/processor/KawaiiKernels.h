@@ -0,0 +1,95 @@
+/**
+ * KawaiiKernels.h — Hot loops compiled per ISA level, picked once by CPUID
+ *
+ * The build targets the compiler's baseline ISA (SSE2 on x86-64), so the
+ * auto-vectorized loops that dominate a block only ever ran 2 doubles or
+ * 4 floats wide. The loops below are compiled several times instead —
+ * KawaiiKernelBodies.h included by one translation unit per ISA level:
+ *
+ *   KawaiiKernels.cpp        baseline — SSE2 on x86-64, NEON on AArch64
+ *   KawaiiKernelsAvx2.cpp    AVX2            (x86 GCC/Clang builds)
+ *   KawaiiKernelsAvx512.cpp  AVX-512 F/DQ/VL (x86 GCC/Clang builds)
+ *
+ * activeKernels() checks the CPU on first use and returns the widest table
+ * it supports, so one binary runs on any x86-64 machine. $KAWAII_KERNELS
+ * (sse2 or avx2) caps the choice, for A/B benchmarks.
+ *
+ * Every variant does the same IEEE operations in the same order per
+ * element (FMA contraction is off for the kernel files, on every
+ * architecture — kawaii_add_isa_kernels in CMakeLists.txt), so all tables
+ * render bit-identical output, the AArch64 baseline included.
+ *
+ * Users fetch the table once, outside process(): voices at construction,
+ * the mix bus at construction. The calls are indirect, so each kernel does
+ * a whole segment or block of work per call.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+// Longest segment partialGroups renders (the voice's filter sub-block)
+static constexpr int kMaxPartialSegment = 32;
+
+// One partial's oscillator over a segment: sin(φ0 + s·inc) · level, times
+// (gain0 + s·dGain) with the spectral gain ramp
+struct PartialJob
+{
+    uint32_t phase0;
+    uint32_t inc;
+    double level;
+    double gain0;
+    double dGain;
+};
+
+// One envelope group's run of jobs — numLowJobs low-band ones, then
+// numFullJobs full-rate ones — and its envelope over the segment
+struct PartialGroup
+{
+    int firstJob;
+    int numLowJobs;
+    int numFullJobs;
+    const double* env;
+};
+
+struct KernelTable
+{
+    const char* isa;
+
+    // Oscillators + envelopes — envelope groups of one voice segment, in one
+    // call. Per group, its jobs sum into groupSum (n samples) or, low-band,
+    // groupLow (numLow samples), then
+    //   sum[s]    += groupSum[s] · env[s]
+    //   lowSum[j] += groupLow[j] · env[lowPos0 + 2j]
+    // Indexed [spectral gain ramp][fast sine]; without the ramp, gain0 and
+    // dGain are ignored. n ≤ kMaxPartialSegment.
+    void (*partialGroups[2][2])(double* sum, double* lowSum, int n, int numLow, int lowPos0,
+                                const PartialJob* jobs, const PartialGroup* groups, int numGroups);
+
+    // Filter packing — dst[s] = float(src[s] · (scale0 + s·dScale)), the
+    // voice's double partial sum into the float block the filter runs on,
+    // with the level modulation's ramp (dScale = 0 without one)
+    void (*packScaled)(float* dst, const double* src, int n, double scale0, double dScale);
+
+    // Mix — dst[i] += src[i]
+    void (*accumulate)(float* dst, const float* src, int n);
+
+    // Mix — dst[i] = softLimit(src[i] · gain) (MixBus::finish)
+    void (*limit)(float* dst, const float* src, int n, float gain, float knee);
+
+    // Pitch — inc[k] = (k + 1) · fundamental for the first `audible`
+    // harmonics, 0 above (a voice's partial increments after a pitch change)
+    void (*harmonicIncrements)(uint32_t* inc, int n, uint32_t fundamental, int audible);
+};
+
+// The table for this CPU, selected on first call (not realtime-safe the
+// first time; cheap afterwards)
+const KernelTable& activeKernels();
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
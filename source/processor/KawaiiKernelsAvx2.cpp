@@ -0,0 +1,27 @@
+/**
+ * KawaiiKernelsAvx2.cpp — Kernels built for AVX2 (see KawaiiKernels.h)
+ *
+ * Compiled with the AVX2 flags set in CMake; only called after
+ * activeKernels() has checked that the CPU supports them.
+ */
+
+#include "KawaiiKernels.h"
+#include "KawaiiPhase.h"
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+namespace {
+#include "KawaiiKernelBodies.h"
+} // namespace
+
+const KernelTable& kernelsAvx2()
+{
+    static constexpr KernelTable table = makeKernelTable("avx2");
+    return table;
+}
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
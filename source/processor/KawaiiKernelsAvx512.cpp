@@ -0,0 +1,27 @@
+/**
+ * KawaiiKernelsAvx512.cpp — Kernels built for AVX-512 (see KawaiiKernels.h)
+ *
+ * Compiled with the AVX-512 F/DQ/VL flags set in CMake; only called after
+ * activeKernels() has checked that the CPU supports them.
+ */
+
+#include "KawaiiKernels.h"
+#include "KawaiiPhase.h"
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+namespace {
+#include "KawaiiKernelBodies.h"
+} // namespace
+
+const KernelTable& kernelsAvx512()
+{
+    static constexpr KernelTable table = makeKernelTable("avx512");
+    return table;
+}
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
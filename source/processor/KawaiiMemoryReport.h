@@ -0,0 +1,66 @@
+/**
+ * KawaiiMemoryReport.h — Per-instance memory accounting
+ *
+ * Bytes an instance holds, split by subsystem, so instance density per
+ * machine can be planned from numbers instead of guesses. Filled by
+ * KawaiiProcessor::memoryReport(); the total reaches the controller as the
+ * read-only Memory Footprint output param, the breakdown is printed by
+ * tools/headless/kawaii_memory.
+ *
+ * Sizes are what is allocated, not what is touched: the arena's unused
+ * reservation and both offload buffer sets count in full. The shared
+ * tables are listed apart — every instance at one sample rate uses the
+ * same copy, so they are paid once per process, not per instance.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+struct MemoryReport
+{
+    enum Subsystem
+    {
+        kEngine,          // processor object: params, governor, selector, voice maps
+        kVoices,          // voice state: partials, envelopes, smoothers
+        kFilterState,     // per-voice sst-filters instance, native SVF, oversampler
+        kWavetable,       // harmonic wavetable + envelope groups (collapsed voices)
+        kDelayLines,      // comb filter delay lines (arena)
+        kMixBus,          // mono mix bus (arena)
+        kModulation,      // modulation tracks: per-tick values for every voice lane (arena)
+        kOffloadStaging,  // osc params, envelope rows, per-voice output, FIFO (arena)
+        kOffloadBackend,  // the backend's own double-buffered sets (Metal shared buffers)
+        kArenaReserve,    // arena reservation not carved by the current layout
+        kDiagnostics,     // trace recorder ring (KAWAII_TRACE_RECORDER)
+        kNumSubsystems
+    };
+
+    std::array<size_t, kNumSubsystems> bytes {};
+    size_t sharedBytes = 0;   // SharedTables for this sample rate, not in total()
+
+    size_t total() const
+    {
+        size_t sum = 0;
+        for (size_t b : bytes)
+            sum += b;
+        return sum;
+    }
+
+    static const char* name(int subsystem)
+    {
+        static constexpr const char* kNames[kNumSubsystems] = {
+            "engine", "voices", "filter state", "wavetable", "delay lines", "mix bus",
+            "modulation", "offload staging", "offload backend", "arena reserve", "diagnostics",
+        };
+        return (subsystem >= 0 && subsystem < kNumSubsystems) ? kNames[subsystem] : "?";
+    }
+};
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
@@ -0,0 +1,83 @@
+/**
+ * KawaiiMixBus.h — Mono voice mix bus with master gain and soft limiter
+ *
+ * Voices are mono (the filter runs once per voice, not per channel), so they
+ * are summed into a single aligned float bus. finish() then makes one pass
+ * over the bus — master gain + soft limiter — writing the first output
+ * channel, and copies that channel to the rest.
+ *
+ * The limiter is linear up to kKnee and bends smoothly (C1) towards ±1 above
+ * it, replacing the old hard clamp:
+ *
+ *   y = sign(x) · (min(|x|, t) + k·o / (k + o)),  o = max(|x| − t, 0), k = 1 − t
+ *
+ * Branch-free min/max/abs/sign, so the loop vectorizes. Both loops run as
+ * the mix kernels of the widest ISA this CPU has (KawaiiKernels.h).
+ *
+ * The bus memory is a region of the processor's RenderArena.
+ */
+
+#pragma once
+
+#include "KawaiiKernels.h"
+
+#include <cstring>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+class MixBus
+{
+public:
+    static constexpr float kKnee = 0.8f;       // limiter is transparent below this
+
+    // Floats to reserve for maxSamples: rounded up so vector loops never
+    // straddle the end of the region
+    static constexpr int capacityFor(int maxSamples) { return (maxSamples + 7) & ~7; }
+
+    // Use `memory` (capacityFor(maxSamples) floats, cache-line aligned) as the bus
+    void attach(float* memory, int maxSamples)
+    {
+        buffer = memory;
+        capacity = memory ? capacityFor(maxSamples) : 0;
+    }
+
+    void detach() { attach(nullptr, 0); }
+
+    float* data() { return buffer; }
+    int getCapacity() const { return capacity; }
+
+    void clear(int numSamples)
+    {
+        std::memset(buffer, 0, sizeof(float) * (size_t)numSamples);
+    }
+
+    // bus[offset + i] += src[i]
+    void accumulate(const float* src, int offset, int numSamples)
+    {
+        kernels->accumulate(buffer + offset, src, numSamples);
+    }
+
+    // Gain + soft limit into outputs[0], then broadcast to the other channels
+    void finish(float** outputs, int numChannels, int numSamples, float gain) const
+    {
+        if (numChannels <= 0)
+            return;
+
+        float* dst = outputs[0];
+        kernels->limit(dst, buffer, numSamples, gain, kKnee);
+
+        for (int ch = 1; ch < numChannels; ch++)
+            std::memcpy(outputs[ch], dst, sizeof(float) * (size_t)numSamples);
+    }
+
+private:
+    float* buffer = nullptr;
+    int capacity = 0;
+    const KernelTable* kernels = &activeKernels();
+};
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
@@ -0,0 +1,264 @@
+/**
+ * KawaiiModulation.h — Control-rate modulation engine: LFOs + mod matrix
+ *
+ * Sources (KawaiiModMatrix.h) are evaluated once per tick of kTickSize
+ * samples — the filter's sub-block — for every voice at once, never per
+ * sample. Per tick, each source and each destination is one row of kLanes
+ * floats, one per voice (padded past kMaxVoices), so the LFO, matrix and
+ * conversion loops run across voices in SIMD.
+ *
+ * A block of n samples has ticks at 0, kTickSize, 2·kTickSize, … and a last
+ * one at n. Voices read a destination at any offset into the block
+ * (valueAt), linear between ticks: cutoff, resonance and pitch once per
+ * filter sub-block, the level gain as a per-sample ramp over each segment.
+ * A voice's sub-block grid restarts at its note-on, so it need not line up
+ * with the ticks.
+ *
+ * Rows hold what the voice applies:
+ *
+ *   Cutoff     frequency ratio, 2^octaves
+ *   Resonance  offset added to Filter Reso
+ *   Level      gain ≥ 0 on all partial levels
+ *   Pitch      semitones on top of bend and Master Tune
+ *
+ * Destinations no slot routes to are never written and routes() is false
+ * for them; voices skip those entirely, so an empty matrix renders
+ * bit-identical to no engine at all.
+ *
+ * The tracks are a region of the processor's RenderArena.
+ */
+
+#pragma once
+
+#include "../entry/KawaiiCids.h"
+#include "../params/KawaiiModMatrix.h"
+#include "../params/KawaiiParams.h"
+#include "KawaiiPhase.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+// One mod matrix slot, amount bipolar −1…1
+struct ModRoute
+{
+    int source = kModSourceOff;
+    int destination = kModDestCutoff;
+    double amount = 0.0;
+};
+
+class ModulationEngine
+{
+public:
+    static constexpr int kTickSize = 32;                     // KawaiiVoice's kFilterBlockSize
+    static constexpr int kLanes = (kMaxVoices + 7) & ~7;     // one per voice, 8 floats wide
+
+    // Ticks of a block of up to maxSamples (both ends included), and the
+    // floats to reserve for them
+    static constexpr int ticksFor(int maxSamples) { return maxSamples / kTickSize + 2; }
+    static constexpr int capacityFor(int maxSamples)
+    {
+        return kNumModDestinations * ticksFor(maxSamples) * kLanes;
+    }
+
+    // Use `memory` (capacityFor(maxSamples) floats, cache-line aligned) for the tracks
+    void attach(float* memory, int maxSamples)
+    {
+        tracks = memory;
+        maxTicks = memory ? ticksFor(maxSamples) : 0;
+        numTicks = 0;
+        blockLength = 0;
+    }
+
+    void detach() { attach(nullptr, 0); }
+
+    void setSampleRate(double sr) { sampleRate = sr; }
+
+    // index 0 = LFO 1 (per voice), 1 = LFO 2 (global)
+    void setLfo(int index, double hz, int shape)
+    {
+        lfoIncrement[(size_t)index] = FixedPhase::increment(hz, sampleRate);
+        lfoShape[(size_t)index] = shape;
+    }
+
+    // Amounts are scaled to the destination's units here, once per change
+    void setRoutes(const std::array<ModRoute, kNumModSlots>& slots)
+    {
+        routed.fill(false);
+        numRoutes = 0;
+        maxPitch = 0.0;
+        for (const auto& slot : slots)
+        {
+            if (slot.source == kModSourceOff || slot.amount == 0.0)
+                continue;
+            double depth = slot.destination == kModDestCutoff ? ParamRanges::kModCutoffOctaves
+                         : slot.destination == kModDestPitch  ? ParamRanges::kModPitchSemitones
+                                                              : 1.0;
+            activeRoutes[(size_t)numRoutes++] = { slot.source, slot.destination, slot.amount * depth };
+            routed[(size_t)slot.destination] = true;
+            if (slot.destination == kModDestPitch)
+                maxPitch += std::abs(slot.amount * depth);
+        }
+    }
+
+    // Mod wheel position (0–1); ramps there from the last value over the
+    // next block
+    void setModWheel(double value) { modWheel = static_cast<float>(value); }
+
+    // A voice started on `lane`: LFO 1 restarts, velocity and note latch
+    void noteOn(int lane, double velocity, double pitch)
+    {
+        lanePhase[(size_t)lane] = 0;
+        laneVelocity[(size_t)lane] = static_cast<float>(velocity);
+        laneNote[(size_t)lane] = static_cast<float>(std::clamp((pitch - 60.0) / 60.0, -1.0, 1.0));
+    }
+
+    // Evaluate every routed destination at this block's ticks, then move the
+    // LFOs to the block's end
+    void render(int numSamples)
+    {
+        blockLength = numSamples;
+        numTicks = numSamples / kTickSize + (numSamples % kTickSize ? 2 : 1);
+
+        if (numRoutes > 0)
+        {
+            const float wheelStep = (modWheel - modWheelStart) / static_cast<float>(std::max(numSamples, 1));
+            for (int k = 0; k < numTicks; k++)
+                renderTick(k, std::min(k * kTickSize, numSamples), wheelStep);
+        }
+        advance(numSamples);
+    }
+
+    // Idle blocks: keep LFO 2 free-running (and the wheel current) without
+    // evaluating anything
+    void advance(int numSamples)
+    {
+        const uint32_t n = static_cast<uint32_t>(numSamples);
+        for (auto& phase : lanePhase)
+            phase += n * lfoIncrement[0];
+        globalPhase += n * lfoIncrement[1];
+        modWheelStart = modWheel;
+    }
+
+    bool routes(int destination) const { return routed[(size_t)destination]; }
+
+    // Largest pitch offset the routed slots can reach (semitones)
+    double maxPitchSemitones() const { return maxPitch; }
+
+    // Destination value for `lane` at `offset` samples into the block,
+    // linear between ticks (offsets past the block's end read the end)
+    float valueAt(int destination, int lane, int offset) const
+    {
+        if (numTicks == 0)
+            return kNeutral[(size_t)destination];
+
+        offset = std::clamp(offset, 0, blockLength);
+        const int k = offset / kTickSize;
+        const float a = row(destination, k)[lane];
+        if (k + 1 >= numTicks)
+            return a;
+
+        const int t0 = k * kTickSize;
+        const int span = std::min(t0 + kTickSize, blockLength) - t0;
+        const float b = row(destination, k + 1)[lane];
+        return a + (b - a) * static_cast<float>(offset - t0) / static_cast<float>(span);
+    }
+
+private:
+    static constexpr std::array<float, kNumModDestinations> kNeutral = { 1.0f, 0.0f, 1.0f, 0.0f };
+
+    float* tracks = nullptr;          // [destination][tick][lane]
+    int maxTicks = 0;
+    int numTicks = 0;
+    int blockLength = 0;
+    double sampleRate = 44100.0;
+
+    std::array<ModRoute, kNumModSlots> activeRoutes {};
+    int numRoutes = 0;
+    std::array<bool, kNumModDestinations> routed {};
+    double maxPitch = 0.0;
+
+    std::array<uint32_t, 2> lfoIncrement {};
+    std::array<int, 2> lfoShape {};
+    alignas(32) std::array<uint32_t, kLanes> lanePhase {};
+    alignas(32) std::array<float, kLanes> laneVelocity {};
+    alignas(32) std::array<float, kLanes> laneNote {};
+    uint32_t globalPhase = 0;
+    float modWheel = 0.0f;
+    float modWheelStart = 0.0f;
+
+    float* row(int destination, int tick) const
+    {
+        return tracks + ((size_t)destination * (size_t)maxTicks + (size_t)tick) * kLanes;
+    }
+
+    static float lfoValue(int shape, uint32_t phase)
+    {
+        // x: position in the cycle, −1 … 1
+        const float x = static_cast<float>(static_cast<int32_t>(phase)) * static_cast<float>(FixedPhase::kHalfCycleInv);
+        switch (shape)
+        {
+            case kLfoTriangle: return 1.0f - 2.0f * std::abs(x);
+            case kLfoSaw:      return x;
+            case kLfoSquare:   return x < 0.0f ? -1.0f : 1.0f;
+            default:           return static_cast<float>(FixedPhase::sine(phase));
+        }
+    }
+
+    // One tick, t samples into the block: sources for every lane, then each
+    // routed destination as the sum of its slots
+    void renderTick(int k, int t, float wheelStep)
+    {
+        alignas(32) float source[kNumModSources][kLanes];
+        const uint32_t t32 = static_cast<uint32_t>(t);
+
+        const uint32_t step1 = t32 * lfoIncrement[0];
+        const float lfo2 = lfoValue(lfoShape[1], globalPhase + t32 * lfoIncrement[1]);
+        const float wheel = modWheelStart + wheelStep * static_cast<float>(t);
+        for (int v = 0; v < kLanes; v++)
+        {
+            source[kModSourceOff][v]      = 0.0f;
+            source[kModSourceLfo1][v]     = lfoValue(lfoShape[0], lanePhase[(size_t)v] + step1);
+            source[kModSourceLfo2][v]     = lfo2;
+            source[kModSourceVelocity][v] = laneVelocity[(size_t)v];
+            source[kModSourceNote][v]     = laneNote[(size_t)v];
+            source[kModSourceModWheel][v] = wheel;
+        }
+
+        for (int d = 0; d < kNumModDestinations; d++)
+        {
+            if (!routed[(size_t)d])
+                continue;
+
+            float* out = row(d, k);
+            for (int v = 0; v < kLanes; v++)
+                out[v] = 0.0f;
+            for (int r = 0; r < numRoutes; r++)
+            {
+                const ModRoute& route = activeRoutes[(size_t)r];
+                if (route.destination != d)
+                    continue;
+                const float amount = static_cast<float>(route.amount);
+                const float* in = source[route.source];
+                for (int v = 0; v < kLanes; v++)
+                    out[v] += amount * in[v];
+            }
+
+            if (d == kModDestCutoff)
+                for (int v = 0; v < kLanes; v++)
+                    out[v] = std::exp2(out[v]);
+            else if (d == kModDestLevel)
+                for (int v = 0; v < kLanes; v++)
+                    out[v] = std::max(0.0f, 1.0f + out[v]);
+        }
+    }
+};
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
@@ -0,0 +1,121 @@
+/**
+ * KawaiiOffloadFifo.h — Constant-latency output for the offload path
+ *
+ * The offload backend hands back the PREVIOUS block's results, so on its
+ * own the delay is the previous block's length: it only equals the
+ * reported latency (maxBlockSize) when every host block is full size, and
+ * a short block after a long one would have to drop samples.
+ *
+ * The FIFO re-chunks instead. Samples are addressed by render time — the
+ * count of samples processed so far — and the block that covers render
+ * times [now, now + n) outputs render times [now − L, now − L + n), with L
+ * the reported latency. Results for a block of n ≤ L samples are always
+ * written (one call later) before they are due, so the delay is exactly L
+ * for any block size sequence, and nothing is dropped. The ring holds 2·L.
+ *
+ * While the processor is idle render time stands still; that is exact as
+ * long as everything audible has been read first (hasPendingAudio()).
+ *
+ * The ring memory is a region of the processor's RenderArena.
+ */
+
+#pragma once
+
+#include "KawaiiMixBus.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+class OffloadFifo
+{
+public:
+    static constexpr int capacityFor(int latencySamples) { return 2 * latencySamples; }
+
+    // Use `memory` (capacityFor(latencySamples) floats) as the ring
+    void attach(float* memory, int latencySamples)
+    {
+        buffer = memory;
+        latency = memory ? latencySamples : 0;
+        size = capacityFor(latency);
+        reset();
+    }
+
+    void detach() { attach(nullptr, 0); }
+
+    // Silence and restart render time at 0
+    void reset()
+    {
+        if (buffer)
+            std::memset(buffer, 0, sizeof(float) * (size_t)size);
+        now = 0;
+        audibleEnd = 0;
+    }
+
+    int64_t renderTime() const { return now; }
+
+    // Zero render times [start, start + len) before results are added there
+    void clear(int64_t start, int len)
+    {
+        forEachRun(start, len, [this](int slot, int, int run) {
+            std::memset(buffer + slot, 0, sizeof(float) * (size_t)run);
+        });
+    }
+
+    // Add results for render times [start, start + len)
+    void add(const float* src, int64_t start, int len)
+    {
+        forEachRun(start, len, [this, src](int slot, int offset, int run) {
+            float* dst = buffer + slot;
+            for (int i = 0; i < run; i++)
+                dst[i] += src[offset + i];
+        });
+    }
+
+    // Results up to render time `end` were not silent
+    void markAudible(int64_t end) { audibleEnd = std::max(audibleEnd, end); }
+
+    // Sum the samples due in this block into the bus, then advance render time
+    void read(MixBus& bus, int numSamples)
+    {
+        int64_t start = now - latency;
+        int skip = static_cast<int>(std::clamp<int64_t>(-start, 0, numSamples));  // before the first block
+        forEachRun(start + skip, numSamples - skip, [this, &bus, skip](int slot, int offset, int run) {
+            bus.accumulate(buffer + slot, skip + offset, run);
+        });
+        now += numSamples;
+    }
+
+    // Something written is still waiting to be read
+    bool hasPendingAudio() const { return now - latency < audibleEnd; }
+
+private:
+    // Split render times [start, start + len) into contiguous ring runs:
+    // fn(slot, offset into the span, run length)
+    template <typename Fn>
+    void forEachRun(int64_t start, int len, Fn&& fn)
+    {
+        int done = 0;
+        while (done < len)
+        {
+            int slot = static_cast<int>((start + done) % size);
+            int run = std::min(len - done, size - slot);
+            fn(slot, done, run);
+            done += run;
+        }
+    }
+
+    float* buffer = nullptr;
+    int latency = 0;
+    int size = 0;
+    int64_t now = 0;
+    int64_t audibleEnd = 0;
+};
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
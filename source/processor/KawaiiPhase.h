@@ -0,0 +1,76 @@
+/**
+ * KawaiiPhase.h — 32-bit fixed-point oscillator phase
+ *
+ * A phase is a uint32_t where 2^32 is one cycle. Advancing is an integer
+ * add, wrapping is unsigned overflow, and the phase s samples ahead is
+ * exactly phase + s·increment — so the CPU loops, the multi-rate band, the
+ * wavetable and the GPU kernel all see the same phase for a partial, however
+ * long the block. Increments change only at note-on and on a pitch change
+ * (bend, Master Tune): no per-sample divide, no wrap branch.
+ *
+ * sine() needs no table: the phase read as a signed int is x ∈ [−1, 1)
+ * half-cycles, and sin(πx) = x·(1 − x²)·P(x²) with a degree-5 P fitted at
+ * Chebyshev nodes (max error 3.4e-9, about −169 dB). Pure arithmetic, so
+ * the oscillator loops keep vectorizing. sineFast() is the degree-3 fit
+ * (1.6e-5, about −96 dB) for the quality governor's reduced tiers.
+ *
+ * The functions are static (internal linkage): the kernels are compiled once
+ * per ISA level (KawaiiKernels.h), and each copy must keep its own sine.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+namespace FixedPhase
+{
+    static constexpr double kCycle = 4294967296.0;            // 2^32
+    static constexpr double kHalfCycleInv = 1.0 / 2147483648.0;
+
+    // Fraction of a cycle (any real) → fixed-point phase, rounded
+    static inline uint32_t fromCycles(double cycles)
+    {
+        cycles -= std::floor(cycles);
+        return static_cast<uint32_t>(static_cast<uint64_t>(cycles * kCycle + 0.5));
+    }
+
+    // Per-sample increment for a frequency
+    static inline uint32_t increment(double frequency, double sampleRate)
+    {
+        return fromCycles(frequency / sampleRate);
+    }
+
+    // sin(2π · phase / 2^32)
+    static inline double sine(uint32_t phase)
+    {
+        double x = static_cast<int32_t>(phase) * kHalfCycleInv;
+        double z = x * x;
+        double p = -3.858947540308215e-4;
+        p = p * z + 6.860079849016426e-3;
+        p = p * z - 7.51871692142057e-2;
+        p = p * z + 5.240361177063636e-1;
+        p = p * z - 2.0261194600460946;
+        p = p * z + 3.141592644338846;
+        return x * (1.0 - z) * p;
+    }
+
+    static inline double sineFast(uint32_t phase)
+    {
+        double x = static_cast<int32_t>(phase) * kHalfCycleInv;
+        double z = x * x;
+        double p = -6.252821740238339e-2;
+        p = p * z + 5.163292044066665e-1;
+        p = p * z - 2.0245942983245313;
+        p = p * z + 3.141545070320233;
+        return x * (1.0 - z) * p;
+    }
+}
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
@@ -1,32 +1,60 @@
 /**
- * KawaiiProcessor.cpp — K50V: 32-partial additive synth with sst-filters
+ * KawaiiProcessor.cpp — K50V: N-partial additive synth with sst-filters
  *
  * Async double-buffered GPU+CPU pipeline:
- *   Phase 1 (CPU): Pre-compute per-partial ADSR envelopes, build VoiceDescriptors
+ *   Phase 1 (CPU): Pre-compute ADSR envelopes (one row per envelope group), build VoiceDescriptors
  *   Phase 2 (GPU): Submit to Metal (non-blocking), retrieve PREVIOUS block's results
- *   Phase 3 (CPU): Per-voice sst-filters processing on previous results + mix to stereo
+ *   Phase 3 (CPU): Per-voice sst-filters processing on previous results + mono mix bus
  *
  * The audio thread never blocks on GPU. One buffer of latency, DAW-compensated via PDC.
- * Falls back to pure CPU path if Metal is unavailable.
+ * Falls back to pure CPU path if Metal is unavailable, and renders inline
+ * whenever the benchmarked costs say that is cheaper for the workload.
+ *
+ * Everything that touches voices is templated on the partial count. setActive()
+ * allocates the VoiceBank<N> for the selected count and points renderFn at
+ * renderVariant<N>, so the per-block code never branches on N.
  */
 
 #include "KawaiiProcessor.h"
 #include "../params/KawaiiParams.h"
+#include "../diagnostics/RealtimeSanitizer.h"
+#include "../gpu/MetalSineBank.h"
+#include "../gpu/CpuSineBank.h"
 #include "pluginterfaces/vst/ivstparameterchanges.h"
 #include "pluginterfaces/vst/ivstevents.h"
 #include "pluginterfaces/base/ibstream.h"
 
 #include <cstring>
+#include <cmath>
 #include <algorithm>
+#include <chrono>
 
 namespace Steinberg {
 namespace Vst {
 namespace Kawaii {
 
+// The platform's offload backend, or nullptr to always render inline
+static std::unique_ptr<SineBankBackend> createOffloadBackend()
+{
+#if KAWAII_OFFLOAD_CPU_STANDIN
+    return std::make_unique<CpuSineBank>();
+#elif defined(__APPLE__)
+    return std::make_unique<MetalSineBank>();
+#else
+    return nullptr;
+#endif
+}
+
 KawaiiProcessor::KawaiiProcessor()
 {
     setControllerClass(ControllerUID);
+    params = defaultParams();
+}
 
+// Every param's initial value — also the base a saved state is read over
+std::array<ParamValue, kNumParams> KawaiiProcessor::defaultParams()
+{
+    std::array<ParamValue, kNumParams> params;
     params.fill(0.0);
     params[kParamMasterVolume] = 0.7;
 
@@ -51,6 +79,35 @@ KawaiiProcessor::KawaiiProcessor()
     params[kParamFilterEnvDep]  = ParamRanges::kFilterEnvDepthDefault;  // 0.5 = no modulation
     params[kParamFilterKeytrk]  = ParamRanges::kFilterKeytrackDefault;  // 0.0 = no tracking
     params[kParamFilterSubType] = 0.0;   // Default subtype variant
+
+    params[kParamPartialCount] =
+        static_cast<double>(kDefaultPartialCountIndex) / (kNumPartialCountOptions - 1);
+    params[kParamEnginePartialCount] = params[kParamPartialCount];
+    params[kParamFilterOversample] = 0.0;  // Off
+    params[kParamFilterSpectral] = 0.0;    // Time Domain
+    params[kParamPartialRendering] = 0.0;  // Full Rate
+    params[kParamQuality] = 0.0;           // Auto
+
+    // Pitch: A4 = 440 Hz, no bend, ±2 semitones, 12-TET
+    params[kParamMasterTune] = 0.5;
+    params[kParamPitchBend] = 0.5;
+    params[kParamPitchBendRange] = ParamRanges::kPitchBendRangeDefault / ParamRanges::kPitchBendRangeMax;
+    for (int n = 0; n < kNumMidiNotes; n++)
+        params[tuningParam(n)] = ParamRanges::tuningPitchToNormalized(n);
+
+    // Modulation: wheel down, both LFOs 2 Hz sine, every slot Off
+    params[kParamModWheel] = 0.0;
+    params[kParamLfo1Rate] = ParamRanges::kLfoRateDefault;
+    params[kParamLfo1Shape] = 0.0;
+    params[kParamLfo2Rate] = ParamRanges::kLfoRateDefault;
+    params[kParamLfo2Shape] = 0.0;
+    for (int slot = 0; slot < kNumModSlots; slot++)
+    {
+        params[modSlotParam(slot, kModSlotOffSource)] = 0.0;   // Off
+        params[modSlotParam(slot, kModSlotOffDest)]   = 0.0;   // Cutoff
+        params[modSlotParam(slot, kModSlotOffAmount)] = 0.5;   // none
+    }
+    return params;
 }
 
 KawaiiProcessor::~KawaiiProcessor()
@@ -67,45 +124,253 @@ tresult PLUGIN_API KawaiiProcessor::initialize(FUnknown* context)
     addAudioOutput(STR16("Stereo Out"), SpeakerArr::kStereo);
     addEventInput(STR16("Event In"), 1);
 
+    offload = createOffloadBackend();
+
+#if KAWAII_TRACE_RECORDER
+    traceRecorder = TraceRecorder::createFromEnvironment(kNumParams);
+#endif
+
     return kResultOk;
 }
 
 tresult PLUGIN_API KawaiiProcessor::terminate()
 {
+    traceRecorder.reset();
+    offload.reset();
+    renderArena.release();
     return AudioEffect::terminate();
 }
 
-tresult PLUGIN_API KawaiiProcessor::setActive(TBool state)
+int KawaiiProcessor::maxBlockSize() const
 {
-    if (state)
+    int maxBlock = (int)processSetup.maxSamplesPerBlock;
+    return maxBlock > 0 ? maxBlock : 4096;
+}
+
+void KawaiiProcessor::layoutRenderBuffers(int numPartials, int maxBlock, bool withGPU)
+{
+    size_t maxOsc = (size_t)kMaxVoices * (size_t)numPartials;
+    size_t block = (size_t)maxBlock;
+
+    // Each group's bytes are recorded for memoryReport()
+    arenaBytes.fill(0);
+    size_t mark = renderArena.getUsed();
+    auto account = [&](MemoryReport::Subsystem subsystem) {
+        arenaBytes[(size_t)subsystem] += renderArena.getUsed() - mark;
+        mark = renderArena.getUsed();
+    };
+
+    gpuOscParams = nullptr;
+    gpuEnvValues = nullptr;
+    gpuVoiceDescs = nullptr;
+    gpuPerVoiceOutput = nullptr;
+    offloadFifo.detach();
+    if (withGPU)
     {
-        for (auto& voice : voices)
-            voice.setSampleRate(processSetup.sampleRate);
+        gpuOscParams = renderArena.carve<OscillatorParams>(maxOsc);
+        gpuEnvValues = renderArena.carve<float>(maxOsc * block);
+        gpuVoiceDescs = renderArena.carve<VoiceDescriptor>(kMaxVoices);
+        gpuPerVoiceOutput = renderArena.carve<float>(kMaxVoices * block);
+        offloadFifo.attach(renderArena.carve<float>((size_t)OffloadFifo::capacityFor(maxBlock)), maxBlock);
+        account(MemoryReport::kOffloadStaging);
+    }
+
+    mixBus.attach(renderArena.carve<float>((size_t)MixBus::capacityFor(maxBlock)), maxBlock);
+    account(MemoryReport::kMixBus);
 
-        int maxOsc = kMaxVoices * kMaxPartials;
-        int maxBlock = (int)processSetup.maxSamplesPerBlock;
-        if (maxBlock <= 0) maxBlock = 4096;
+    modulation.attach(renderArena.carve<float>((size_t)ModulationEngine::capacityFor(maxBlock)), maxBlock);
+    account(MemoryReport::kModulation);
 
-        // Initialize Metal with per-voice support
-        bool gpuOk = metalSineBank.init(maxOsc, maxBlock, kMaxVoices);
+    delayLineFloats = maxFilterDelayLineSize() * 4;
+    for (auto& delayLine : voiceDelayLines)
+        delayLine = delayLineFloats > 0 ? renderArena.carve<float>(delayLineFloats) : nullptr;
+    account(MemoryReport::kDelayLines);
+}
 
-        // Allocate CPU-side buffers for hybrid GPU+CPU pipeline
-        gpuOscParams.resize((size_t)maxOsc);
-        gpuEnvValues.resize((size_t)(maxOsc * maxBlock));
-        gpuVoiceDescs.resize(kMaxVoices);
-        gpuPerVoiceOutput.resize((size_t)(kMaxVoices * maxBlock));
+// Allocate the voice bank for partial count N and carve its render buffers
+template <int N>
+void KawaiiProcessor::activateVariant()
+{
+    sharedTables = SharedTables::acquire(processSetup.sampleRate);
 
-        // Enable GPU if Metal initialized successfully
-        useGPU = gpuOk && metalSineBank.isAvailable();
+    auto bank = std::make_unique<VoiceBank<N>>();
+    for (int v = 0; v < kMaxVoices; v++)
+    {
+        auto& voice = bank->voices[(size_t)v];
+        voice.setSampleRate(processSetup.sampleRate);
+        voice.setSharedTables(sharedTables.get());
+        voice.setModulation(&modulation, v);
     }
-    else
+    modulation.setSampleRate(processSetup.sampleRate);
+
+    int maxOsc = kMaxVoices * N;
+    int maxBlock = maxBlockSize();
+
+    // Initialize the offload backend with per-voice support
+    offloadReady = offload && offload->init(maxOsc, maxBlock, kMaxVoices) && offload->isAvailable();
+
+    // The backend runs one (variable) block behind; offloadFifo turns that
+    // into a constant delay of one full block
+    offloadLatency = offloadReady ? maxBlock : 0;
+
+    // Carve the render buffers. setupProcessing() normally reserved enough
+    // already; reserve() only allocates if this layout is larger.
+    renderArena.beginMeasure();
+    layoutRenderBuffers(N, maxBlock, offloadReady);
+    renderArena.reserve(renderArena.measuredBytes());
+    layoutRenderBuffers(N, maxBlock, offloadReady);
+
+    for (int v = 0; v < kMaxVoices; v++)
+        bank->voices[(size_t)v].setDelayLineStorage(voiceDelayLines[(size_t)v], delayLineFloats);
+
+    voiceBank = std::move(bank);
+    activePartialCount = N;
+    renderFn = &KawaiiProcessor::renderVariant<N>;
+
+    governor.prepare(processSetup.sampleRate, processSetup.processMode == kRealtime);
+
+    // Push current params into the fresh voices before the first block.
+    // They start configured for the inline path (wavetable collapse allowed).
+    auto& fresh = static_cast<VoiceBank<N>&>(*voiceBank);
+    bool wasOffload = useGPU;
+    useGPU = false;
+    updateParameters(fresh);
+    // Not on the audio thread yet: bake the collapse table in one go
+    if (fresh.wavetable.bakeStep(sharedTables->sine(), HarmonicWavetable<N>::kWholeBake))
+        updateParameters(fresh);
+    paramsDirty = false;
+    applyPitch(fresh);
+    pitchDirty = false;
+
+    // Price both render paths for this configuration, then pick one: the
+    // path the last safe point requested (this activation is the restart it
+    // asked for), else the best for the workload the last activation saw.
+    // The pick is always reported: the controller only restarts the host
+    // when it actually changed.
+    if (offloadReady)
     {
-        metalSineBank.shutdown();
-        useGPU = false;
+        benchmarkBackends(fresh, maxBlock);
+        useGPU = scripted        ? scriptedOffload
+               : switchRequested ? requestedOffload
+                                 : backendSelector.preferOffload(wasOffload, { expectedVoices, maxBlock });
+        if (useGPU)
+            updateParameters(fresh);
+        offloadFifo.reset();   // drop the benchmark's audio
+    }
+    switchRequested = false;
+    backendSelector.takeWorkload();
+    backendReportPending = true;
+    memoryReportPending = true;
+    reportedPartialCount = N;
+    partialCountReportPending = true;
+}
 
-        for (auto& voice : voices)
-            for (auto& p : voice.partials)
-                p.reset();
+// Time one render path: numVoices sustained voices, average audio-thread
+// time per block of blockSize (after one warm-up block)
+template <int N>
+double KawaiiProcessor::timeRenderPath(VoiceBank<N>& bank, bool offloadPath, int numVoices, int blockSize)
+{
+    static constexpr int kBlocks = 4;
+
+    for (int v = 0; v < numVoices; v++)
+        bank.voices[(size_t)v].noteOn(48 + v, 0.8);
+
+    double total = 0.0;
+    for (int b = 0; b <= kBlocks; b++)
+    {
+        mixBus.clear(blockSize);
+        auto start = std::chrono::steady_clock::now();
+        if (offloadPath)
+            processBlockGPU(bank, mixBus.data(), blockSize);
+        else
+            processBlockCPU(bank, mixBus.data(), blockSize);
+        if (b > 0)
+            total += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    for (auto& voice : bank.voices)
+        voice.kill();
+    if (offloadPath)
+    {
+        offload->reset();
+        prevGpuNumVoices = 0;
+    }
+    return total / kBlocks;
+}
+
+// Benchmark inline and offload rendering on the real bank and hand the
+// fitted costs to the selector. Blocks for a few ms — setActive() only.
+template <int N>
+void KawaiiProcessor::benchmarkBackends(VoiceBank<N>& bank, int maxBlock)
+{
+    static constexpr int kBenchmarkBlock = 512;
+    int block = std::min(maxBlock, kBenchmarkBlock);
+
+    PathCost inlineCost = PathCost::fit(timeRenderPath(bank, false, 1, block),
+                                        timeRenderPath(bank, false, kMaxVoices, block),
+                                        kMaxVoices, block);
+    PathCost offloadCost = PathCost::fit(timeRenderPath(bank, true, 1, block),
+                                         timeRenderPath(bank, true, kMaxVoices, block),
+                                         kMaxVoices, block);
+
+    // Round trip for a full bank: submit, then wait for the results
+    for (int v = 0; v < kMaxVoices; v++)
+        bank.voices[(size_t)v].noteOn(48 + v, 0.8);
+    mixBus.clear(block);
+    processBlockGPU(bank, mixBus.data(), block);
+    offload->reset();
+    auto start = std::chrono::steady_clock::now();
+    processBlockGPU(bank, mixBus.data(), block);
+    offload->reset();
+    double roundTrip = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (auto& voice : bank.voices)
+        voice.kill();
+    prevGpuNumVoices = 0;
+    mixBus.clear(block);
+
+    bool viable = roundTrip <= BackendSelector::kRoundTripBudget * block / processSetup.sampleRate;
+    backendSelector.setCosts(inlineCost, offloadCost, viable);
+}
+
+tresult PLUGIN_API KawaiiProcessor::setActive(TBool state)
+{
+    if (state)
+    {
+        // The partial count is structural (voice layout, GPU buffer sizes),
+        // so it is only read here — changes apply on the next activation.
+        switch (partialCountFromNormalized(params[kParamPartialCount]))
+        {
+            case 8:   activateVariant<8>();   break;
+            case 16:  activateVariant<16>();  break;
+            case 64:  activateVariant<64>();  break;
+            case 128: activateVariant<128>(); break;
+            default:  activateVariant<32>();  break;
+        }
+
+        // No render buffer may be (re)allocated until deactivation
+        renderArena.seal();
+
+        if (traceRecorder)
+            traceRecorder->recordActivate(processSetup, useGPU, params.data());
+    }
+    else
+    {
+        if (traceRecorder)
+            traceRecorder->recordDeactivate();
+
+        if (offloadReady)
+            offload->shutdown();
+        offloadReady = false;
+
+        renderFn = nullptr;
+        voiceBank.reset();
+        mixBus.detach();
+        offloadFifo.detach();
+        arenaBytes.fill(0);     // the whole block is reserve again
+        renderArena.unseal();   // keeps the block for the next activation
+        sharedTables.reset();
+        activePartialCount = 0;
+        prevGpuNumVoices = 0;
     }
 
     return AudioEffect::setActive(state);
@@ -113,7 +378,17 @@ tresult PLUGIN_API KawaiiProcessor::setActive(TBool state)
 
 tresult PLUGIN_API KawaiiProcessor::setupProcessing(ProcessSetup& newSetup)
 {
-    return AudioEffect::setupProcessing(newSetup);
+    tresult result = AudioEffect::setupProcessing(newSetup);
+    if (result != kResultOk)
+        return result;
+
+    // Reserve the arena for the current partial count at the new block size,
+    // assuming the GPU path (its staging buffers are the largest regions)
+    renderArena.beginMeasure();
+    layoutRenderBuffers(partialCountFromNormalized(params[kParamPartialCount]), maxBlockSize(), true);
+    renderArena.reserve(renderArena.measuredBytes());
+    arenaBytes.fill(0);   // measured, not carved
+    return result;
 }
 
 tresult PLUGIN_API KawaiiProcessor::canProcessSampleSize(int32 symbolicSampleSize)
@@ -128,14 +403,13 @@ uint32 PLUGIN_API KawaiiProcessor::getLatencySamples()
     // Async double buffering adds one buffer of latency when GPU is active.
     // The DAW uses this to shift other tracks forward (plugin delay compensation).
     if (useGPU)
-        return static_cast<uint32>(metalSineBank.getLatencySamples());
+        return static_cast<uint32>(offloadLatency);
     return 0;
 }
 
-void KawaiiProcessor::updateParameters()
+template <int N>
+void KawaiiProcessor::updateParameters(VoiceBank<N>& bank)
 {
-    using namespace ParamRanges;
-
     // --- Filter params (shared across all voices) ---
     // Pass normalized cutoff directly — voice smooths in normalized space
     // then converts to Hz per-sample for perceptually uniform sweeps
@@ -150,51 +424,178 @@ void KawaiiProcessor::updateParameters()
     int filterSubType = static_cast<int>(params[kParamFilterSubType] * 3 + 0.5);
     filterSubType = std::clamp(filterSubType, 0, 3);
 
-    // Filter envelope ADSR (same exponential time mapping as partial envelopes)
-    double fAtk = normalizedToMs(params[kParamFilterEnvAtk], kEnvAttackMin, kEnvAttackMax) / 1000.0;
-    double fDec = normalizedToMs(params[kParamFilterEnvDec], kEnvDecayMin, kEnvDecayMax) / 1000.0;
+    // Envelope coefficients come straight from the shared time-constant
+    // curves (same exponential time mapping as normalizedToMs)
+    const SharedTables& tables = *sharedTables;
+
+    // Filter envelope ADSR (same curves as the partial envelopes)
+    double fAtk = tables.envelopeCoeff(SharedTables::kEnvAttack,  params[kParamFilterEnvAtk]);
+    double fDec = tables.envelopeCoeff(SharedTables::kEnvDecay,   params[kParamFilterEnvDec]);
     double fSus = params[kParamFilterEnvSus];
-    double fRel = normalizedToMs(params[kParamFilterEnvRel], kEnvReleaseMin, kEnvReleaseMax) / 1000.0;
+    double fRel = tables.envelopeCoeff(SharedTables::kEnvRelease, params[kParamFilterEnvRel]);
 
     // Env depth: normalized 0–1 → bipolar -1 to +1 (0.5 = no modulation)
     double filterEnvDepth = (params[kParamFilterEnvDep] - 0.5) * 2.0;
 
     double filterKeytrack = params[kParamFilterKeytrk];
 
-    for (auto& voice : voices)
+    // Filter oversampling: discrete Off/2×/4× mapped from normalized 0–1
+    static constexpr int kOversampleFactors[] = { 1, 2, 4 };
+    int osIndex = std::clamp(static_cast<int>(params[kParamFilterOversample] * 2 + 0.5), 0, 2);
+    int filterOversample = kOversampleFactors[osIndex];
+
+    // Filter mode: Time Domain / Spectral
+    bool filterSpectral = params[kParamFilterSpectral] >= 0.5;
+
+    // Partial rendering: Full Rate / Multi-Rate (CPU path, next note-on)
+    bool multiRate = params[kParamPartialRendering] >= 0.5;
+
+    // Quality: index 0 = Auto, 1… = pinned tier 0…
+    int qualityIndex = static_cast<int>(params[kParamQuality] * static_cast<int>(QualityGovernor::kNumTiers) + 0.5);
+    governor.setPinnedTier(qualityIndex == 0 ? QualityGovernor::kAuto
+                                             : std::min(qualityIndex - 1, QualityGovernor::kNumTiers - 1));
+    int tier = governor.getTier();
+    if (tier >= QualityGovernor::kTierNoOversampling)
+        filterOversample = 1;
+
+    // Envelope groups: partials whose ADSR params are equal get one envelope.
+    // Equal normalized params map to equal envelope coefficients.
+    auto sameAdsr = [this](int a, int b) {
+        for (int off = kPartialOffAttack; off <= kPartialOffRelease; off++)
+            if (params[partialParam(a, off)] != params[partialParam(b, off)])
+                return false;
+        return true;
+    };
+
+    EnvelopeGroups<N> groups;
+    for (int i = 0; i < N; i++)
+    {
+        int g = 0;
+        while (g < groups.numGroups && !sameAdsr(i, groups.leader[(size_t)g]))
+            g++;
+        if (g == groups.numGroups)
+            groups.leader[(size_t)groups.numGroups++] = static_cast<uint8_t>(i);
+        groups.groupOf[(size_t)i] = static_cast<uint8_t>(g);
+    }
+
+    if (!groups.samePartition(bank.envelopeGroups))
+    {
+        groups.generation = bank.envelopeGroups.generation + 1;
+        bank.envelopeGroups = groups;
+    }
+
+    // Wavetable collapse: a single group means the voice output is one
+    // spectrum times one envelope — the shared table holds the levels. New
+    // levels are baked over the next blocks (renderVariant); until then
+    // voices render per partial. CPU path only (the GPU synthesizes partials
+    // itself).
+    const HarmonicWavetable<N>* wavetable = nullptr;
+    if (!useGPU && groups.numGroups == 1)
+    {
+        std::array<double, N> levels;
+        for (int i = 0; i < N; i++)
+            levels[(size_t)i] = params[partialParam(i, kPartialOffLevel)];
+        bank.wavetable.setLevels(levels);
+        if (bank.wavetable.ready())
+            wavetable = &bank.wavetable;
+    }
+
+    for (auto& voice : bank.voices)
     {
         // --- Per-partial params ---
-        for (int i = 0; i < kMaxPartials; i++)
+        for (int i = 0; i < N; i++)
         {
             // Level
             voice.partials[i].level = params[partialParam(i, kPartialOffLevel)];
 
-            // ADSR (convert normalized 0-1 to real seconds)
-            double aSec = normalizedToMs(params[partialParam(i, kPartialOffAttack)],  kEnvAttackMin,  kEnvAttackMax) / 1000.0;
-            double dSec = normalizedToMs(params[partialParam(i, kPartialOffDecay)],   kEnvDecayMin,   kEnvDecayMax) / 1000.0;
-            double sLvl = params[partialParam(i, kPartialOffSustain)];
-            double rSec = normalizedToMs(params[partialParam(i, kPartialOffRelease)], kEnvReleaseMin, kEnvReleaseMax) / 1000.0;
+            // ADSR (normalized 0-1 → one-pole coefficients)
+            double aCoeff = tables.envelopeCoeff(SharedTables::kEnvAttack,  params[partialParam(i, kPartialOffAttack)]);
+            double dCoeff = tables.envelopeCoeff(SharedTables::kEnvDecay,   params[partialParam(i, kPartialOffDecay)]);
+            double sLvl   = params[partialParam(i, kPartialOffSustain)];
+            double rCoeff = tables.envelopeCoeff(SharedTables::kEnvRelease, params[partialParam(i, kPartialOffRelease)]);
 
-            voice.partials[i].envelope.setAttack(aSec);
-            voice.partials[i].envelope.setDecay(dSec);
+            voice.partials[i].envelope.setAttackCoeff(aCoeff);
+            voice.partials[i].envelope.setDecayCoeff(dCoeff);
             voice.partials[i].envelope.setSustain(sLvl);
-            voice.partials[i].envelope.setRelease(rSec);
+            voice.partials[i].envelope.setReleaseCoeff(rCoeff);
         }
 
+        voice.setEnvelopeGroups(&bank.envelopeGroups);
+        voice.setWavetable(wavetable);
+
         // --- Filter params ---
         voice.setFilterCutoffNorm(filterCutoffNorm);
         voice.setFilterResonance(filterReso);
         voice.setFilterConfig(filterTypeIndex, filterSubType);
-        voice.setFilterEnvAttack(fAtk);
-        voice.setFilterEnvDecay(fDec);
+        voice.setFilterOversampling(filterOversample);
+        voice.setSpectralFilter(filterSpectral);
+        voice.setMultiRatePartials(multiRate);
+        voice.setPartialCulling(tier >= QualityGovernor::kTierCullPartials);
+        voice.setFastSine(tier >= QualityGovernor::kTierFastSine);
+        voice.setFilterEnvAttackCoeff(fAtk);
+        voice.setFilterEnvDecayCoeff(fDec);
         voice.setFilterEnvSustain(fSus);
-        voice.setFilterEnvRelease(fRel);
+        voice.setFilterEnvReleaseCoeff(fRel);
         voice.setFilterEnvDepth(filterEnvDepth);
         voice.setFilterKeytrack(filterKeytrack);
     }
+
+    // --- Modulation: LFOs and the mod matrix (engine-wide, not per voice) ---
+    auto lfoHz = [this](ParamID id) {
+        return normalizedToHz(params[id], ParamRanges::kLfoRateMinHz, ParamRanges::kLfoRateMaxHz);
+    };
+    modulation.setLfo(0, lfoHz(kParamLfo1Rate), listIndexFromNormalized(params[kParamLfo1Shape], kNumLfoShapes));
+    modulation.setLfo(1, lfoHz(kParamLfo2Rate), listIndexFromNormalized(params[kParamLfo2Shape], kNumLfoShapes));
+
+    std::array<ModRoute, kNumModSlots> routes;
+    for (int slot = 0; slot < kNumModSlots; slot++)
+    {
+        routes[(size_t)slot].source =
+            listIndexFromNormalized(params[modSlotParam(slot, kModSlotOffSource)], kNumModSources);
+        routes[(size_t)slot].destination =
+            listIndexFromNormalized(params[modSlotParam(slot, kModSlotOffDest)], kNumModDestinations);
+        routes[(size_t)slot].amount = (params[modSlotParam(slot, kModSlotOffAmount)] - 0.5) * 2.0;
+    }
+
+    // Pitch routes widen the multi-rate headroom (applyPitch)
+    double maxModPitch = modulation.maxPitchSemitones();
+    modulation.setRoutes(routes);
+    if (modulation.maxPitchSemitones() != maxModPitch)
+        pitchDirty = true;
+}
+
+// Pitch bend + Master Tune → one control-rate offset for the whole bank.
+// One exp2() per change here; each sounding voice then rescales all of its
+// partial increments in a single kernel pass (KawaiiVoice::setPitchOffset).
+template <int N>
+void KawaiiProcessor::applyPitch(VoiceBank<N>& bank)
+{
+    using namespace ParamRanges;
+
+    double bendRange = params[kParamPitchBendRange] * kPitchBendRangeMax;
+    double bend = (params[kParamPitchBend] - 0.5) * 2.0 * bendRange;
+    double tune = (params[kParamMasterTune] - 0.5) * 2.0 * kMasterTuneCents / 100.0;
+
+    double semitones = bend + tune;
+    double ratio = std::exp2(semitones / 12.0);
+    double maxRatio = std::exp2((bendRange + tune + modulation.maxPitchSemitones()) / 12.0);
+
+    for (auto& voice : bank.voices)
+    {
+        voice.setMaxPitchRatio(maxRatio);
+        voice.setPitchOffset(semitones, ratio);
+    }
+}
+
+// Tuned pitch of a MIDI note (semitones, 69 = A4), from the tuning table
+double KawaiiProcessor::notePitch(int note) const
+{
+    note = std::clamp(note, 0, kNumMidiNotes - 1);
+    return ParamRanges::normalizedToTuningPitch(params[tuningParam(note)]);
 }
 
-void KawaiiProcessor::processEvent(const Event& event)
+template <int N>
+void KawaiiProcessor::processEvent(VoiceBank<N>& bank, const Event& event)
 {
     switch (event.type)
     {
@@ -202,14 +603,14 @@ void KawaiiProcessor::processEvent(const Event& event)
         {
             if (event.noteOn.velocity == 0.0f)
             {
-                for (auto& voice : voices)
+                for (auto& voice : bank.voices)
                     if (voice.getNoteNumber() == event.noteOn.pitch && voice.isActive())
                         voice.noteOff();
             }
             else
             {
-                KawaiiVoice* target = nullptr;
-                for (auto& voice : voices)
+                KawaiiVoice<N>* target = nullptr;
+                for (auto& voice : bank.voices)
                 {
                     if (!voice.isActive())
                     {
@@ -218,16 +619,18 @@ void KawaiiProcessor::processEvent(const Event& event)
                     }
                 }
                 if (!target)
-                    target = &voices[0];
+                    target = &bank.voices[0];
 
-                target->noteOn(event.noteOn.pitch, event.noteOn.velocity);
+                double pitch = notePitch(event.noteOn.pitch);
+                target->noteOn(event.noteOn.pitch, event.noteOn.velocity, pitch);
+                modulation.noteOn(static_cast<int>(target - bank.voices.data()), event.noteOn.velocity, pitch);
             }
             break;
         }
 
         case Event::kNoteOffEvent:
         {
-            for (auto& voice : voices)
+            for (auto& voice : bank.voices)
                 if (voice.getNoteNumber() == event.noteOff.pitch && voice.isActive())
                     voice.noteOff();
             break;
@@ -246,20 +649,24 @@ void KawaiiProcessor::processEvent(const Event& event)
 // One buffer of latency, compensated by DAW via getLatencySamples().
 // ============================================================================
 
-void KawaiiProcessor::processBlockGPU(float** outputs, int32 numChannels, int32 numSamples, double masterVol)
+template <int N>
+void KawaiiProcessor::processBlockGPU(VoiceBank<N>& bank, float* mix, int32 numSamples)
 {
-    double sr = processSetup.sampleRate;
+    auto& voices = bank.voices;
 
     // =========================================================================
     // Phase 1: CPU — Prepare current block for GPU dispatch
     //
     // Collect oscillators grouped by voice, pre-compute per-sample ADSR
-    // envelopes, build VoiceDescriptors, record voice mapping.
+    // envelopes (one row per active envelope group, shared by the group's
+    // oscillators via envRow), build VoiceDescriptors, record voice mapping.
     // =========================================================================
 
     int numOsc = 0;
+    int numEnvRows = 0;
     int numVoices = 0;
     std::array<int, kMaxVoices> currentVoiceMap;
+    std::array<bool, kMaxVoices> currentSpectral;
 
     for (int v = 0; v < kMaxVoices; v++)
     {
@@ -268,40 +675,102 @@ void KawaiiProcessor::processBlockGPU(float** outputs, int32 numChannels, int32
 
         int voiceStartOsc = numOsc;
 
-        for (int p = 0; p < kMaxPartials; p++)
+        // Pitch modulation holds for the whole block here (the increments
+        // are per block); the level gain becomes one ramp per block
+        voice.applyPitchModulation(0);
+        const float levelStart = static_cast<float>(voice.levelModulation(0));
+        const float levelEnd = static_cast<float>(voice.levelModulation(numSamples));
+        const bool levelRamp = levelStart != 1.0f || levelEnd != 1.0f;
+
+        // Spectral filter: the filter is this block's per-partial gain ramp,
+        // folded into the oscillator levels — Phase 3 skips the voice
+        bool spectral = voice.usesSpectralFilter();
+        if (spectral)
+        {
+            voice.applyFilterModulation(numSamples);
+            voice.prepareSpectralBlock(numSamples);
+        }
+
+        // Run each active group's ADSR forward per-sample on CPU, capturing
+        // values for GPU. (ADSR is sequential/stateful — cannot be
+        // parallelized on GPU.) -1 marks a finished group.
+        std::array<int, N> groupRow;
+        std::array<double, N> groupCull;   // quality governor: cull below (block start)
+        for (int g = 0; g < voice.getNumEnvelopeGroups(); g++)
+        {
+            auto& envelope = voice.groupEnvelope(g);
+            groupCull[(size_t)g] = voice.cullThreshold(g);
+            if (!envelope.isActive())
+            {
+                groupRow[(size_t)g] = -1;
+                continue;
+            }
+
+            groupRow[(size_t)g] = numEnvRows;
+            float* row = &gpuEnvValues[(size_t)(numEnvRows * numSamples)];
+            for (int32 s = 0; s < numSamples; s++)
+                row[s] = static_cast<float>(envelope.process());
+            numEnvRows++;
+        }
+
+        for (int p = 0; p < N; p++)
         {
             auto& partial = voice.partials[p];
-            if (!partial.envelope.isActive()) continue;
+            int g = voice.envelopeGroupOf(p);
+            int row = groupRow[(size_t)g];
+            if (row < 0) continue;
+
+            float level = static_cast<float>(partial.level);
+            float gain  = spectral ? voice.getSpectralGain(p)  : 1.0f;
+            float delta = spectral ? voice.getSpectralDelta(p) : 0.0f;
+
+            const uint32_t increment = voice.getIncrement(p);
+            if (level * gain < groupCull[(size_t)g])
+            {
+                partial.phase += static_cast<uint32_t>(numSamples) * increment;
+                continue;
+            }
+
+            // The product of the spectral and level ramps, as the line
+            // through its values at the block's ends
+            float amplitude = level * gain;
+            float slope = level * delta;
+            if (levelRamp)
+            {
+                float end = (amplitude + slope * static_cast<float>(numSamples)) * levelEnd;
+                amplitude *= levelStart;
+                slope = (end - amplitude) / static_cast<float>(numSamples);
+            }
 
             gpuOscParams[(size_t)numOsc] = {
-                static_cast<float>(partial.phase),
-                static_cast<float>(partial.frequency / sr),
-                static_cast<float>(partial.level),
-                1.0f  // unused — velocity applied via VoiceDescriptor
+                partial.phase,
+                increment,
+                amplitude,
+                static_cast<float>(row),
+                slope,
+                { 0.0f, 0.0f, 0.0f }
             };
 
-            // Run ADSR forward per-sample on CPU, capturing values for GPU.
-            // (ADSR is sequential/stateful — cannot be parallelized on GPU.)
-            for (int32 s = 0; s < numSamples; s++)
-                gpuEnvValues[(size_t)(numOsc * numSamples + s)] =
-                    static_cast<float>(partial.envelope.process());
-
-            // Advance phase on CPU (double precision for accuracy)
-            partial.phase += numSamples * (partial.frequency / sr);
-            partial.phase -= static_cast<int>(partial.phase);
+            // Advance phase on CPU — the same fixed-point step the kernel
+            // takes per sample, so both stay exactly in phase
+            partial.phase += static_cast<uint32_t>(numSamples) * increment;
 
             numOsc++;
         }
 
+        if (spectral)
+            voice.concludeSpectralBlock();
+
         gpuVoiceDescs[(size_t)numVoices] = {
             static_cast<uint32_t>(voiceStartOsc),
             static_cast<uint32_t>(numOsc - voiceStartOsc),
-            static_cast<float>(voice.getVelocity() / static_cast<double>(kMaxPartials)),
+            static_cast<float>(voice.getVelocity() / static_cast<double>(N)),
             0.0f
         };
 
         // Record which voices[] index maps to this GPU voice index
         currentVoiceMap[(size_t)numVoices] = v;
+        currentSpectral[(size_t)numVoices] = spectral;
         numVoices++;
     }
 
@@ -315,20 +784,23 @@ void KawaiiProcessor::processBlockGPU(float** outputs, int32 numChannels, int32
     int prevNumVoices = 0;
     int prevNumSamples = 0;
 
-    metalSineBank.processBlock(
-        gpuOscParams.data(),
-        gpuEnvValues.data(),
+    offload->processBlock(
+        gpuOscParams,
+        gpuEnvValues,
         numOsc,
-        gpuVoiceDescs.data(),
+        numEnvRows,
+        gpuVoiceDescs,
         numVoices,
         numSamples,
-        gpuPerVoiceOutput.data(),
+        gpuPerVoiceOutput,
         prevNumVoices,
         prevNumSamples
     );
 
     // =========================================================================
-    // Phase 3: CPU — Filter PREVIOUS block's GPU output + mix to stereo
+    // Phase 3: CPU — Filter PREVIOUS block's GPU output into the offload FIFO,
+    // then read this block's output from it (one full block behind, whatever
+    // the host's block sizes — see KawaiiOffloadFifo.h)
     //
     // Uses prevGpuVoiceMap (saved from the PREVIOUS call) to know which
     // voice[] entry each GPU voice index corresponds to.
@@ -341,9 +813,14 @@ void KawaiiProcessor::processBlockGPU(float** outputs, int32 numChannels, int32
     //   eliminating zipper noise from parameter changes.
     // =========================================================================
 
+    // The previous block covered render times [now − prevNumSamples, now)
+    const int64_t prevStart = offloadFifo.renderTime() - prevNumSamples;
+    offloadFifo.clear(prevStart, prevNumSamples);
+
     if (prevNumVoices > 0 && prevNumSamples > 0)
     {
-        int totalSamples = std::min(prevNumSamples, numSamples);
+        int totalSamples = prevNumSamples;
+        offloadFifo.markAudible(prevStart + prevNumSamples);
 
         for (int i = 0; i < prevNumVoices; i++)
         {
@@ -352,6 +829,13 @@ void KawaiiProcessor::processBlockGPU(float** outputs, int32 numChannels, int32
 
             float* voiceBuf = &gpuPerVoiceOutput[(size_t)(i * prevNumSamples)];
 
+            // Filtered spectrally on the way in (Phase 1 of that block)
+            if (prevGpuSpectral[(size_t)i])
+            {
+                offloadFifo.add(voiceBuf, prevStart, totalSamples);
+                continue;
+            }
+
             // Process in sub-blocks matching sst-filters' internal block size
             for (int subStart = 0; subStart < totalSamples; subStart += kFilterBlockSize)
             {
@@ -371,36 +855,32 @@ void KawaiiProcessor::processBlockGPU(float** outputs, int32 numChannels, int32
                 }
 
                 // Compute effective cutoff Hz using voice helper
-                // (exponential Hz mapping + envelope mod + keytrack)
+                // (exponential Hz mapping + envelope mod + keytrack + mod
+                // matrix). The matrix ticks are this block's, so on this path
+                // cutoff/resonance modulation leads the audio by one block.
+                voice.applyFilterModulation(subEnd);
                 double effectiveCutoff = voice.computeEffectiveCutoff(smoothedNorm, envValue);
 
                 // Compute target coefficients for this sub-block.
                 // sst-filters internally interpolates per-sample via deltaC.
-                voice.prepareFilterBlock(effectiveCutoff, smoothedReso);
-
-                // Tight inner loop: filter each sample through sst-filters + mix to stereo
-                for (int32 s = subStart; s < subEnd; s++)
-                {
-                    float sample = voiceBuf[s];
-                    sample = voice.filterBlockStep(sample);
+                voice.prepareFilterBlock(effectiveCutoff, voice.effectiveResonance(smoothedReso));
 
-                    for (int32 ch = 0; ch < numChannels; ch++)
-                        outputs[ch][s] += static_cast<float>(sample * masterVol);
-                }
+                // Filter the sub-block in place through the kernel selected
+                // for this filter config, then sum into the FIFO
+                voice.filterBlock(voiceBuf + subStart, subLen);
+                offloadFifo.add(voiceBuf + subStart, prevStart + subStart, subLen);
 
-                // Signal end of sub-block so sst-filters snaps coefficients
+                // Signal end of sub-block so the filter snaps coefficients
                 voice.concludeFilterBlock();
             }
         }
-
-        // Clamp
-        for (int32 ch = 0; ch < numChannels; ch++)
-            for (int32 s = 0; s < numSamples; s++)
-                outputs[ch][s] = std::clamp(outputs[ch][s], -1.0f, 1.0f);
     }
 
+    offloadFifo.read(mixBus, numSamples);
+
     // Save current voice mapping for the NEXT call's Phase 3
     prevGpuVoiceMap = currentVoiceMap;
+    prevGpuSpectral = currentSpectral;
     prevGpuNumVoices = numVoices;
 }
 
@@ -408,26 +888,257 @@ void KawaiiProcessor::processBlockGPU(float** outputs, int32 numChannels, int32
 // CPU render path — includes per-voice sst-filters processing
 // ============================================================================
 
-void KawaiiProcessor::processBlockCPU(float** outputs, int32 numChannels, int32 numSamples, double masterVol)
+template <int N>
+void KawaiiProcessor::processBlockCPU(VoiceBank<N>& bank, float* mix, int32 numSamples)
 {
-    for (auto& voice : voices)
+    for (auto& voice : bank.voices)
     {
         if (!voice.isActive())
             continue;
 
-        for (int32 i = 0; i < numSamples; i++)
-        {
-            double outL = 0.0, outR = 0.0;
-            voice.process(&outL, &outR);
+        voice.renderBlock(mix, numSamples);
+    }
+}
+
+// ============================================================================
+// Idle detection
+//
+// Idle = no sounding voice AND nothing left in flight on the GPU or waiting
+// in the offload FIFO. The GPU path plays one full block late: the blocks
+// after the last voice ends still have that voice's tail to filter and mix.
+// ============================================================================
+
+template <int N>
+bool KawaiiProcessor::isIdle(const VoiceBank<N>& bank) const
+{
+    if (useGPU && (prevGpuNumVoices > 0 || offloadFifo.hasPendingAudio()))
+        return false;
+
+    for (const auto& voice : bank.voices)
+        if (voice.isActive())
+            return false;
+    return true;
+}
+
+// Quality governor, last tier: drop the quietest voice that is already
+// releasing (held notes are never shed)
+template <int N>
+void KawaiiProcessor::shedQuietestReleasingVoice(VoiceBank<N>& bank)
+{
+    KawaiiVoice<N>* quietest = nullptr;
+    for (auto& voice : bank.voices)
+        if (voice.isReleasing() && (!quietest || voice.getLoudness() < quietest->getLoudness()))
+            quietest = &voice;
+
+    if (quietest)
+        quietest->kill();
+}
+
+// ============================================================================
+// Render path selection at the safe point
+//
+// Only called while idle. A different path is only requested here: it is
+// reported through kParamRenderBackend, the controller answers the change
+// with restartComponent(kLatencyChanged), and the setActive(true) of that
+// restart switches. Until then the old path keeps rendering, so the audio
+// keeps the latency the host last queried.
+// ============================================================================
+
+void KawaiiProcessor::reevaluateBackend()
+{
+    auto workload = backendSelector.takeWorkload();
+    if (workload.voices == 0)
+        return;
+
+    expectedVoices = workload.voices;
+    if (!offloadReady)
+        return;
+
+    bool selected = switchRequested ? requestedOffload : useGPU.load();
+    bool offloadPath = scripted ? scriptedOffload : backendSelector.preferOffload(selected, workload);
+    if (offloadPath == selected)
+        return;
+
+    // Picking the path in use again withdraws the request
+    switchRequested = offloadPath != useGPU;
+    requestedOffload = offloadPath;
+    backendReportPending = true;
+}
+
+void KawaiiProcessor::scriptDecisions(int tier, bool overBudget, bool offload)
+{
+    scripted = true;
+    scriptedOffload = offload;
+    governor.script(tier, overBudget);
+}
+
+// One point on a read-only output param; false if the host gave no queue
+static bool sendOutputParam(ProcessData& data, ParamID id, ParamValue value)
+{
+    if (!data.outputParameterChanges)
+        return false;
+
+    int32 queueIndex = 0;
+    IParamValueQueue* queue = data.outputParameterChanges->addParameterData(id, queueIndex);
+    if (!queue)
+        return false;
+
+    int32 pointIndex = 0;
+    return queue->addPoint(0, value, pointIndex) == kResultOk;
+}
+
+// Send the selected path (kParamRenderBackend: the one in use, or the one
+// requested for the next activation) and the footprint
+// (kParamMemoryFootprint) as read-only outputs; each is retried every block
+// until the host takes it. kParamEnginePartialCount carries the active
+// partial count, and the requested one as soon as that differs: the
+// controller restarts the component on the change, and the setActive(true)
+// that follows builds the new voice bank.
+void KawaiiProcessor::reportOutputParams(ProcessData& data)
+{
+    int requestedCount = partialCountFromNormalized(params[kParamPartialCount]);
+    if (requestedCount != reportedPartialCount)
+    {
+        reportedPartialCount = requestedCount;
+        partialCountReportPending = true;
+    }
+    if (partialCountReportPending
+        && sendOutputParam(data, kParamEnginePartialCount, partialCountToNormalized(reportedPartialCount)))
+        partialCountReportPending = false;
+
+    bool selected = switchRequested ? requestedOffload : useGPU.load();
+    if (backendReportPending && sendOutputParam(data, kParamRenderBackend, selected ? 1.0 : 0.0))
+        backendReportPending = false;
+
+    if (memoryReportPending)
+    {
+        double megabytes = static_cast<double>(memoryReport().total()) / (1024.0 * 1024.0);
+        double normalized = std::min(megabytes / ParamRanges::kMemoryFootprintMaxMB, 1.0);
+        if (sendOutputParam(data, kParamMemoryFootprint, normalized))
+            memoryReportPending = false;
+    }
+}
+
+// ============================================================================
+// Memory accounting
+// ============================================================================
+
+MemoryReport KawaiiProcessor::memoryReport() const
+{
+    MemoryReport report;
+    report.bytes[MemoryReport::kEngine] = sizeof(*this);
 
-            for (int32 ch = 0; ch < numChannels; ch++)
-                outputs[ch][i] += static_cast<float>((ch == 0 ? outL : outR) * masterVol);
+    if (voiceBank)
+        voiceBank->account(report);
+
+    for (int s = 0; s < MemoryReport::kNumSubsystems; s++)
+        report.bytes[(size_t)s] += arenaBytes[(size_t)s];
+    report.bytes[MemoryReport::kArenaReserve] =
+        renderArena.getCapacity() - std::min(renderArena.getCapacity(), renderArena.getUsed());
+
+    if (offload)
+        report.bytes[MemoryReport::kOffloadBackend] = offload->getMemoryBytes();
+    if (traceRecorder)
+        report.bytes[MemoryReport::kDiagnostics] = TraceRecorder::kRingBytes + kNumParams * sizeof(double);
+
+    if (sharedTables)
+        report.sharedBytes = sharedTables->memoryBytes();
+    return report;
+}
+
+// ============================================================================
+// Per-variant block: events, voice params, render
+// ============================================================================
+
+template <int N>
+void KawaiiProcessor::renderVariant(ProcessData& data)
+{
+    auto& bank = static_cast<VoiceBank<N>&>(*voiceBank);
+
+    // Pitch first, so this block's note-ons start at the current bend
+    if (pitchDirty)
+    {
+        applyPitch(bank);
+        pitchDirty = false;
+    }
+
+    // MIDI events
+    if (data.inputEvents)
+    {
+        int32 numEvents = data.inputEvents->getEventCount();
+        for (int32 i = 0; i < numEvents; i++)
+        {
+            Event event;
+            if (data.inputEvents->getEvent(i, event) == kResultOk)
+                processEvent(bank, event);
         }
     }
 
-    for (int32 ch = 0; ch < numChannels; ch++)
-        for (int32 i = 0; i < numSamples; i++)
-            outputs[ch][i] = std::clamp(outputs[ch][i], -1.0f, 1.0f);
+    // Voices keep their settings between blocks, so they only need pushing
+    // when something changed (including while idle — a note-on must start
+    // with current params)
+    if (paramsDirty)
+    {
+        updateParameters(bank);
+        paramsDirty = false;
+    }
+
+    // One slice of a pending wavetable bake; a finished one reaches the
+    // voices through updateParameters() next block
+    if (bank.wavetable.bakeStep(sharedTables->sine()))
+        paramsDirty = true;
+
+    // Read every block: the wheel moves too often for a full parameter push
+    modulation.setModWheel(params[kParamModWheel]);
+
+    if (data.numOutputs == 0)
+        return;
+
+    int32 numChannels = data.outputs[0].numChannels;
+    int32 numSamples = data.numSamples;
+    float** outputs = data.outputs[0].channelBuffers32;
+
+    // Idle fast path: no voice work, no GPU dispatch, no mix pass. Outputs
+    // are still zeroed — hosts are not required to honour silenceFlags.
+    // Note-ons above were already applied, so a new note leaves this path
+    // in the same block it arrives.
+    if (isIdle(bank))
+    {
+        reevaluateBackend();
+        modulation.advance(numSamples);
+
+        for (int32 ch = 0; ch < numChannels; ch++)
+            memset(outputs[ch], 0, (size_t)numSamples * sizeof(float));
+        data.outputs[0].silenceFlags = (numChannels >= 64) ? ~uint64(0)
+                                                            : ((uint64(1) << numChannels) - 1);
+        return;
+    }
+
+    data.outputs[0].silenceFlags = 0;
+
+    int activeVoices = 0;
+    for (const auto& voice : bank.voices)
+        activeVoices += voice.isActive() ? 1 : 0;
+    backendSelector.observe(activeVoices, numSamples);
+
+    if (governor.getTier() >= QualityGovernor::kTierShedVoices && governor.isOverBudget())
+        shedQuietestReleasingVoice(bank);
+
+    // Modulation for the whole block, all voices at once, before any voice
+    // reads it
+    modulation.render(numSamples);
+
+    // Voices sum into the mono bus; finish() overwrites every output channel
+    mixBus.clear(numSamples);
+    float* mix = mixBus.data();
+
+    if (useGPU)
+        processBlockGPU(bank, mix, numSamples);
+    else
+        processBlockCPU(bank, mix, numSamples);
+
+    mixBus.finish(outputs, numChannels, numSamples,
+                  static_cast<float>(params[kParamMasterVolume]));
 }
 
 // ============================================================================
@@ -436,6 +1147,13 @@ void KawaiiProcessor::processBlockCPU(float** outputs, int32 numChannels, int32
 
 tresult PLUGIN_API KawaiiProcessor::process(ProcessData& data)
 {
+    // Sanitizer builds: flag any allocation/lock/blocking call from here on
+    KAWAII_RT_SCOPE();
+
+    // A state loaded since the last block goes into the trace ahead of it
+    if (traceRecorder)
+        traceRecorder->recordPendingState();
+
     // Parameter changes
     if (data.inputParameterChanges)
     {
@@ -452,46 +1170,39 @@ tresult PLUGIN_API KawaiiProcessor::process(ProcessData& data)
                 {
                     ParamID id = paramQueue->getParameterId();
                     if (id < kNumParams)
+                    {
                         params[id] = value;
+                        // Pitch params skip the full parameter push; the
+                        // tuning table is only read at note-on and the mod
+                        // wheel every block
+                        if (id == kParamPitchBend || id == kParamPitchBendRange || id == kParamMasterTune)
+                            pitchDirty = true;
+                        else if (id < kParamTuningBase || id > kParamModWheel)
+                            paramsDirty = true;
+                    }
                 }
             }
         }
     }
 
-    // MIDI events
-    if (data.inputEvents)
-    {
-        int32 numEvents = data.inputEvents->getEventCount();
-        for (int32 i = 0; i < numEvents; i++)
-        {
-            Event event;
-            if (data.inputEvents->getEvent(i, event) == kResultOk)
-                processEvent(event);
-        }
-    }
-
-    updateParameters();
-
-    if (data.numOutputs == 0)
-        return kResultOk;
-
-    int32 numChannels = data.outputs[0].numChannels;
-    int32 numSamples = data.numSamples;
-    float** outputs = data.outputs[0].channelBuffers32;
-
-    if (data.symbolicSampleSize == kSample64)
+    if (data.numOutputs > 0 && data.symbolicSampleSize == kSample64)
         return kResultFalse;
 
-    for (int32 ch = 0; ch < numChannels; ch++)
-        memset(outputs[ch], 0, (size_t)numSamples * sizeof(float));
+    if (!renderFn)
+        return kResultOk;
 
-    double masterVol = params[kParamMasterVolume];
+    // A tier change reaches the voices through updateParameters() next block
+    auto start = QualityGovernor::now();
+    (this->*renderFn)(data);
+    if (governor.endBlock(start, data.numSamples))
+        paramsDirty = true;
 
-    if (useGPU)
-        processBlockGPU(outputs, numChannels, numSamples, masterVol);
-    else
-        processBlockCPU(outputs, numChannels, numSamples, masterVol);
+    reportOutputParams(data);
 
+    if (traceRecorder)
+        traceRecorder->recordBlock(data, { static_cast<uint8_t>(governor.getTier()),
+                                           static_cast<uint8_t>(governor.isOverBudget()),
+                                           static_cast<uint8_t>(useGPU) });
     return kResultOk;
 }
 
@@ -501,14 +1212,35 @@ tresult PLUGIN_API KawaiiProcessor::setState(IBStream* state)
     if (!state)
         return kResultFalse;
 
-    for (auto& param : params)
+    // The state is read over the defaults: one saved before params were
+    // appended ends early, and everything after its end must come back to
+    // its default — not keep whatever the previous patch set. A failed read
+    // leaves params untouched.
+    auto loaded = defaultParams();
+    int32 numRead = 0;
+    for (auto& param : loaded)
     {
         float value;
-        int32 numBytesRead;
+        int32 numBytesRead = 0;
         if (state->read(&value, sizeof(float), &numBytesRead) != kResultOk)
             return kResultFalse;
+        if (numBytesRead != sizeof(float))
+            break;
         param = value;
+        numRead++;
     }
+
+    // Master Tune did nothing before the pitch params existed, and those
+    // states mostly hold 0 for it — restore A4 = 440 Hz
+    if (numRead <= kParamPitchBend)
+        loaded[kParamMasterTune] = 0.5;
+    params = loaded;
+
+    paramsDirty = true;
+    pitchDirty = true;
+
+    if (traceRecorder)
+        traceRecorder->recordState(params.data());
     return kResultOk;
 }
 
@@ -4,6 +4,9 @@
  * Hybrid GPU+CPU pipeline with async double buffering.
  * GPU computes per-voice sin+sum (non-blocking), CPU applies per-voice filter.
  * One buffer of latency reported to DAW for PDC.
+ *
+ * Whether the offload path or the inline CPU path renders is chosen per
+ * workload (see KawaiiBackendSelector.h).
  */
 
 #pragma once
@@ -12,8 +15,18 @@
 #include "pluginterfaces/vst/ivstevents.h"
 #include "../entry/KawaiiCids.h"
 #include "KawaiiVoice.h"
-#include "../gpu/MetalSineBank.h"
+#include "KawaiiMixBus.h"
+#include "KawaiiModulation.h"
+#include "KawaiiArena.h"
+#include "KawaiiOffloadFifo.h"
+#include "KawaiiQualityGovernor.h"
+#include "KawaiiBackendSelector.h"
+#include "KawaiiMemoryReport.h"
+#include "../gpu/SineBankBackend.h"
+#include "../diagnostics/TraceRecorder.h"
 #include <array>
+#include <atomic>
+#include <memory>
 #include <vector>
 
 namespace Steinberg {
@@ -40,27 +53,130 @@ public:
     // Report latency from async double buffering so DAW can compensate
     uint32 PLUGIN_API getLatencySamples() override;
 
+    // Replay (kawaii_replay): end the next block with this quality tier and
+    // over-budget state, and use this render path at the next activation or
+    // safe point — the timing-driven decisions a trace recorded
+    void scriptDecisions(int tier, bool overBudget, bool offload);
+
+    // Bytes this instance holds, per subsystem (see KawaiiMemoryReport.h).
+    // Reflects the current activation; cheap and allocation-free.
+    MemoryReport memoryReport() const;
+
 private:
-    void updateParameters();
-    void processEvent(const Steinberg::Vst::Event& event);
-    void processBlockGPU(float** outputs, int32 numChannels, int32 numSamples, double masterVol);
-    void processBlockCPU(float** outputs, int32 numChannels, int32 numSamples, double masterVol);
+    // Voice storage for one partial-count variant. Only the variant selected
+    // by kParamPartialCount is allocated (in setActive()).
+    struct VoiceBankBase
+    {
+        virtual ~VoiceBankBase() = default;
+        virtual void account(MemoryReport& report) const = 0;
+    };
+
+    template <int N>
+    struct VoiceBank : VoiceBankBase
+    {
+        std::array<KawaiiVoice<N>, kMaxVoices> voices;
+        HarmonicWavetable<N> wavetable;          // shared by collapsed voices
+        EnvelopeGroups<N> envelopeGroups;        // partials with identical ADSR
+
+        void account(MemoryReport& report) const override
+        {
+            size_t filterBytes = voices.size() * KawaiiVoice<N>::filterStateBytes();
+            report.bytes[MemoryReport::kVoices] += sizeof(voices) - filterBytes;
+            report.bytes[MemoryReport::kFilterState] += filterBytes;
+            report.bytes[MemoryReport::kWavetable] += sizeof(wavetable) + sizeof(envelopeGroups);
+        }
+    };
+
+    template <int N> void activateVariant();
+    template <int N> void renderVariant(ProcessData& data);
+    template <int N> void updateParameters(VoiceBank<N>& bank);
+    template <int N> void applyPitch(VoiceBank<N>& bank);
+    template <int N> void processEvent(VoiceBank<N>& bank, const Steinberg::Vst::Event& event);
+    template <int N> void processBlockGPU(VoiceBank<N>& bank, float* mix, int32 numSamples);
+    template <int N> void processBlockCPU(VoiceBank<N>& bank, float* mix, int32 numSamples);
+    template <int N> bool isIdle(const VoiceBank<N>& bank) const;
+    template <int N> void shedQuietestReleasingVoice(VoiceBank<N>& bank);
+    template <int N> void benchmarkBackends(VoiceBank<N>& bank, int maxBlock);
+    template <int N> double timeRenderPath(VoiceBank<N>& bank, bool offloadPath, int numVoices, int blockSize);
+
+    // At idle: request the other render path (for the next activation) if
+    // the last busy period's workload says so
+    void reevaluateBackend();
+    void reportOutputParams(ProcessData& data);
+    double notePitch(int note) const;
+    static std::array<ParamValue, kNumParams> defaultParams();
+
+    // Carve every render buffer for a partial count from renderArena — or, in
+    // the arena's measure pass, only count them
+    void layoutRenderBuffers(int numPartials, int maxBlock, bool withGPU);
+    int maxBlockSize() const;
+
+    std::unique_ptr<VoiceBankBase> voiceBank;
+    int activePartialCount = 0;
+
+    // Render entry point for the active variant — renderVariant<activePartialCount>
+    void (KawaiiProcessor::*renderFn)(ProcessData&) = nullptr;
 
-    std::array<KawaiiVoice, kMaxVoices> voices;
     std::array<ParamValue, kNumParams> params;
 
-    // GPU synthesis — async double-buffered hybrid pipeline
-    MetalSineBank metalSineBank;
-    bool useGPU = false;
-    std::vector<OscillatorParams> gpuOscParams;
-    std::vector<float> gpuEnvValues;
-    std::vector<VoiceDescriptor> gpuVoiceDescs;
-    std::vector<float> gpuPerVoiceOutput;  // receives PREVIOUS block's GPU results
+    // Read-only tables shared with every instance at this sample rate
+    std::shared_ptr<const SharedTables> sharedTables;
+    bool paramsDirty = true;  // params changed since the last updateParameters()
+    bool pitchDirty = true;   // bend / bend range / Master Tune changed since applyPitch()
+
+    // Picks the quality tier from process() load (or the pinned Quality param)
+    QualityGovernor governor;
+
+    // Backing store for all render buffers below. Reserved in
+    // setupProcessing(), carved in setActive(), sealed while active.
+    RenderArena renderArena;
+    std::array<size_t, MemoryReport::kNumSubsystems> arenaBytes {};  // current layout's regions
+
+    // Mono sum of all voices; gain + limiter + channel broadcast in finish()
+    MixBus mixBus;
+
+    // LFOs + mod matrix, evaluated once per block for every voice lane
+    // (lane = index in the bank); voices read it while they render
+    ModulationEngine modulation;
+
+    // Comb filter delay lines, one region per voice (all 4 SIMD lanes)
+    std::array<float*, kMaxVoices> voiceDelayLines {};
+    size_t delayLineFloats = 0;
+
+    // GPU synthesis — async double-buffered hybrid pipeline.
+    // offload is the platform's backend (nullptr if it has none); useGPU is
+    // the path in use, kept across deactivation as the selector's hysteresis.
+    // It only changes in setActive() — process() can merely request a
+    // switch (requestedOffload) for the restart that follows — and is atomic
+    // because hosts read getLatencySamples() from their own threads.
+    std::unique_ptr<SineBankBackend> offload;
+    bool offloadReady = false;     // initialized for this activation
+    std::atomic<bool> useGPU { false };
+    bool switchRequested = false;  // the safe point picked the other path …
+    bool requestedOffload = false; // … this one, for the next activation
+    int offloadLatency = 0;        // reported while useGPU
+    BackendSelector backendSelector;
+    int expectedVoices = 1;        // last busy period's peak, for the next activation
+    bool backendReportPending = false;  // kParamRenderBackend not yet sent to the host
+    bool memoryReportPending = false;   // kParamMemoryFootprint not yet sent
+    int reportedPartialCount = 0;       // last kParamEnginePartialCount value …
+    bool partialCountReportPending = false; // … and whether it is still unsent
+    bool scripted = false;              // replaying: decisions come from scriptDecisions()
+    bool scriptedOffload = false;
+
+    // KAWAII_TRACE_RECORDER builds with $KAWAII_TRACE_DIR set; nullptr otherwise
+    std::unique_ptr<TraceRecorder> traceRecorder;
+    OscillatorParams* gpuOscParams = nullptr;
+    float* gpuEnvValues = nullptr;
+    VoiceDescriptor* gpuVoiceDescs = nullptr;
+    float* gpuPerVoiceOutput = nullptr;  // receives PREVIOUS block's GPU results
+    OffloadFifo offloadFifo;             // re-chunks them to a constant one-block delay
 
     // Voice mapping for the PREVIOUS GPU dispatch.
     // Needed so Phase 3 (filter) knows which voice[] entry each GPU voice index
     // corresponds to, even if voice activity changed since the dispatch.
     std::array<int, kMaxVoices> prevGpuVoiceMap;  // prevGpuVoiceMap[gpuIdx] = voices[] index
+    std::array<bool, kMaxVoices> prevGpuSpectral; // voice was filtered spectrally in Phase 1
     int prevGpuNumVoices = 0;
 };
 
@@ -0,0 +1,151 @@
+/**
+ * KawaiiQualityGovernor.h — Degrade gracefully under CPU pressure
+ *
+ * Times every process() call against the duration of the audio it produced
+ * (load 1.0 = the whole deadline) and, while the load stays above kHighLoad,
+ * steps through quality tiers. Tiers are cumulative — tier n keeps every
+ * measure below it:
+ *
+ *   1  Cull partials whose level × envelope is below −60 dB
+ *   2  Cheaper sine polynomial (−96 dB instead of −169 dB)
+ *   3  Filter oversampling off
+ *   4  Shed the quietest releasing voice, one per block while over budget
+ *
+ * Escalation waits kEscalateHoldSeconds between steps so each tier gets
+ * measured before the next one; recovery takes one step down after load
+ * has stayed below kLowLoad for kRecoverHoldSeconds. The gap between the
+ * two thresholds keeps it from oscillating between neighbouring tiers.
+ *
+ * The load estimate follows spikes at once and decays slowly. Offline
+ * rendering has no deadline, so Auto stays at full quality there; a pinned
+ * tier applies in both modes.
+ *
+ * Replay (kawaii_replay) scripts the outcome of each block instead, so a
+ * recorded run's tier changes repeat exactly whatever the replay's timing.
+ */
+
+#pragma once
+
+#include <chrono>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+class QualityGovernor
+{
+public:
+    enum Tier
+    {
+        kTierFull,
+        kTierCullPartials,
+        kTierFastSine,
+        kTierNoOversampling,
+        kTierShedVoices,
+        kNumTiers
+    };
+
+    static constexpr int    kAuto = -1;
+    static constexpr double kHighLoad = 0.75;
+    static constexpr double kLowLoad  = 0.45;
+    static constexpr double kEscalateHoldSeconds = 0.05;
+    static constexpr double kRecoverHoldSeconds  = 1.0;
+    static constexpr double kLoadDecay = 0.1;   // per block, towards a lower load
+
+    using Clock = std::chrono::steady_clock;
+
+    void prepare(double sr, bool isRealtime)
+    {
+        sampleRate = sr;
+        realtime = isRealtime;
+        reset();
+    }
+
+    void reset()
+    {
+        tier = (pinned != kAuto) ? pinned : kTierFull;
+        load = 0.0;
+        samplesSinceChange = 0.0;
+        headroomSamples = 0.0;
+    }
+
+    // kAuto, or a Tier to hold regardless of load
+    void setPinnedTier(int t)
+    {
+        pinned = t;
+        if (pinned != kAuto)
+            tier = pinned;
+    }
+
+    static Clock::time_point now() { return Clock::now(); }
+
+    // Replay: the next endBlock() ends in this state instead of measuring
+    void script(int t, bool overBudget)
+    {
+        scripted = true;
+        scriptedTier = t;
+        scriptedOverBudget = overBudget;
+    }
+
+    // After each block: fold its process() time into the load estimate and
+    // step the tier. True when the tier changed.
+    bool endBlock(Clock::time_point start, int numSamples)
+    {
+        if (numSamples <= 0 || sampleRate <= 0.0)
+            return false;
+
+        if (scripted)
+        {
+            bool changed = (scriptedTier != tier);
+            tier = scriptedTier;
+            load = scriptedOverBudget ? 1.0 : 0.0;
+            return changed;
+        }
+
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        double blockLoad = elapsed * sampleRate / numSamples;
+        load = (blockLoad > load) ? blockLoad : load + (blockLoad - load) * kLoadDecay;
+
+        if (pinned != kAuto || !realtime)
+            return false;
+
+        samplesSinceChange += numSamples;
+        headroomSamples = (load < kLowLoad) ? headroomSamples + numSamples : 0.0;
+
+        int next = tier;
+        if (load > kHighLoad && tier < kNumTiers - 1
+            && samplesSinceChange >= kEscalateHoldSeconds * sampleRate)
+            next = tier + 1;
+        else if (tier > kTierFull && headroomSamples >= kRecoverHoldSeconds * sampleRate)
+            next = tier - 1;
+
+        if (next == tier)
+            return false;
+
+        tier = next;
+        samplesSinceChange = 0.0;
+        headroomSamples = 0.0;
+        return true;
+    }
+
+    int getTier() const { return tier; }
+    double getLoad() const { return load; }
+    bool isOverBudget() const { return load > kHighLoad; }
+
+private:
+    double sampleRate = 44100.0;
+    bool realtime = true;
+    int pinned = kAuto;
+    int tier = kTierFull;
+    double load = 0.0;
+    double samplesSinceChange = 0.0;
+    double headroomSamples = 0.0;
+
+    bool scripted = false;
+    int scriptedTier = kTierFull;
+    bool scriptedOverBudget = false;
+};
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
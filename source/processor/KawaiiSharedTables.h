@@ -0,0 +1,167 @@
+/**
+ * KawaiiSharedTables.h — Process-wide, read-only lookup tables
+ *
+ * Every instance needs the same constant data: note → frequency, per-note
+ * partial tan(π·f/sr) for the spectral filter, envelope time-constant curves,
+ * the cutoff curve and a sine cycle for wavetable baking. Instead of each
+ * instance computing (and holding) its own copy, acquire() hands out one
+ * immutable SharedTables per sample rate, built lazily by the first instance
+ * that activates at that rate and freed when the last one releases it.
+ *
+ * acquire() locks and may allocate — call it from setActive(), never from
+ * process(). Everything after that is const reads, safe from any thread.
+ *
+ * Curves indexed by a normalized parameter are sampled at kCurvePoints and
+ * linearly interpolated; the curves are smooth exponentials, so the
+ * relative error stays around 1e-5 (far below audibility for times and
+ * cutoffs).
+ */
+
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "../entry/KawaiiCids.h"
+#include "../params/KawaiiParams.h"
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+class SharedTables
+{
+public:
+    static constexpr int kSineSize    = 4096;   // ≥ every HarmonicWavetable size
+    static constexpr int kNumNotes    = 128;
+    static constexpr int kCurvePoints = 1024;   // intervals; +1 points stored
+
+    enum EnvStage { kEnvAttack, kEnvDecay, kEnvRelease, kNumEnvStages };
+
+    // Tables for sampleRate — shared with every other live instance at that
+    // rate. Not realtime-safe.
+    static std::shared_ptr<const SharedTables> acquire(double sampleRate)
+    {
+        static std::mutex mutex;
+        static std::vector<std::weak_ptr<const SharedTables>> cache;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::shared_ptr<const SharedTables> found;
+        cache.erase(std::remove_if(cache.begin(), cache.end(),
+            [&](const std::weak_ptr<const SharedTables>& weak) {
+                auto live = weak.lock();
+                if (live && !found && live->sampleRate == sampleRate)
+                    found = live;
+                return !live;
+            }), cache.end());
+
+        if (!found)
+        {
+            found = std::shared_ptr<const SharedTables>(new SharedTables(sampleRate));
+            cache.push_back(found);
+        }
+        return found;
+    }
+
+    double getSampleRate() const { return sampleRate; }
+
+    // Everything held, for memory accounting (shared — not per instance)
+    size_t memoryBytes() const { return sizeof(*this) + tanHalf.capacity() * sizeof(double); }
+
+    // One sine cycle, kSineSize samples + guard point
+    const float* sine() const { return sineTable.data(); }
+
+    // 12-TET, A4 (69) = 440 Hz
+    double noteFrequency(int note) const
+    {
+        return noteHz[(size_t)std::clamp(note, 0, kNumNotes - 1)];
+    }
+
+    // tan(π·k·f0/sr) for partials k = 1 … kMaxPartials of a note; 0 where the
+    // partial is at or above Nyquist (muted)
+    const double* partialTanHalf(int note) const
+    {
+        return &tanHalf[(size_t)std::clamp(note, 0, kNumNotes - 1) * kMaxPartials];
+    }
+
+    // One-pole envelope coefficient 1 − e^(−1/(T·sr)) for a normalized
+    // attack/decay/release param (same time mapping as normalizedToMs)
+    double envelopeCoeff(EnvStage stage, double normalized) const
+    {
+        return lookup(envCurves[(size_t)stage], normalized);
+    }
+
+    // Filter cutoff curve: 20 Hz · 1000^normalized
+    double cutoffHz(double normalized) const
+    {
+        return lookup(cutoffCurve, normalized);
+    }
+
+private:
+    using Curve = std::array<double, kCurvePoints + 1>;
+
+    explicit SharedTables(double sr)
+        : sampleRate(sr)
+    {
+        using namespace ParamRanges;
+
+        for (int j = 0; j < kSineSize; j++)
+            sineTable[(size_t)j] = static_cast<float>(std::sin(2.0 * M_PI * j / kSineSize));
+        sineTable[kSineSize] = sineTable[0];
+
+        double nyquist = sr / 2.0;
+        tanHalf.resize((size_t)kNumNotes * kMaxPartials);
+        for (int n = 0; n < kNumNotes; n++)
+        {
+            noteHz[(size_t)n] = 440.0 * std::pow(2.0, (n - 69) / 12.0);
+            for (int k = 0; k < kMaxPartials; k++)
+            {
+                double f = noteHz[(size_t)n] * (k + 1);
+                tanHalf[(size_t)(n * kMaxPartials + k)] =
+                    (f < nyquist) ? std::tan(M_PI * f / sr) : 0.0;
+            }
+        }
+
+        const double ranges[kNumEnvStages][2] = {
+            { kEnvAttackMin,  kEnvAttackMax },
+            { kEnvDecayMin,   kEnvDecayMax },
+            { kEnvReleaseMin, kEnvReleaseMax },
+        };
+        for (int st = 0; st < kNumEnvStages; st++)
+        {
+            for (int i = 0; i <= kCurvePoints; i++)
+            {
+                double norm = static_cast<double>(i) / kCurvePoints;
+                double seconds = std::max(0.001, normalizedToMs(norm, ranges[st][0], ranges[st][1]) / 1000.0);
+                envCurves[(size_t)st][(size_t)i] = 1.0 - std::exp(-1.0 / (seconds * sr));
+            }
+        }
+
+        for (int i = 0; i <= kCurvePoints; i++)
+            cutoffCurve[(size_t)i] = kFilterCutoffMin
+                * std::pow(kFilterCutoffMax / kFilterCutoffMin, static_cast<double>(i) / kCurvePoints);
+    }
+
+    static double lookup(const Curve& curve, double normalized)
+    {
+        double pos = std::clamp(normalized, 0.0, 1.0) * kCurvePoints;
+        int i = std::min(static_cast<int>(pos), kCurvePoints - 1);
+        double frac = pos - i;
+        return curve[(size_t)i] + (curve[(size_t)i + 1] - curve[(size_t)i]) * frac;
+    }
+
+    double sampleRate;
+    std::array<float, kSineSize + 1> sineTable;
+    std::array<double, kNumNotes> noteHz;
+    std::vector<double> tanHalf;                  // [note * kMaxPartials + k]
+    std::array<Curve, kNumEnvStages> envCurves;
+    Curve cutoffCurve;
+};
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
@@ -1,11 +1,18 @@
 /**
- * KawaiiVoice.h — 32-Partial Additive Voice with Surge XT sst-filters
+ * KawaiiVoice.h — N-Partial Additive Voice with Surge XT sst-filters
  *
- * Each voice has 32 sine oscillators in a harmonic series.
+ * Each voice has NumPartials sine oscillators in a harmonic series. The
+ * partial count is a template parameter (8/16/32/64/128) so per-partial
+ * loops have compile-time trip counts — small variants unroll fully and
+ * keep their state in registers.
  * Each partial has its own:
  *   - Level (gain knob)
  *   - ADSR envelope (independent shaping per harmonic)
  *
+ * Partials with identical ADSR settings are grouped (EnvelopeGroups): only
+ * the group leader's envelope runs, and it scales the group's partial sum.
+ * Envelope cost is per distinct setting, not per partial.
+ *
  * After the partials are summed, the signal passes through one of
  * Surge XT's 33 filter types via the sst-filters++ library, with its
  * own ADSR envelope, envelope depth, and keyboard tracking.
@@ -13,6 +20,49 @@
  * The sst-filters++ Filter uses SIMD-based QuadFilterUnit internally
  * (SSE on x86, NEON on ARM via SIMDE). We use processMonoSample()
  * for single-voice processing — one Filter instance per voice.
+ * In KAWAII_NATIVE_SVF builds, filter types we can model natively (the
+ * linear Cytomic SVF modes) bypass the library and run a statically
+ * dispatched kernel from KawaiiFilterKernels.h; the kernel is chosen once
+ * per filter config.
+ *
+ * Patches where every partial shares one ADSR (a single group) collapse to
+ * a single-cycle wavetable (KawaiiWavetable.h): one table read and one
+ * envelope per sample. The collapse is chosen at note-on and undone mid-note
+ * as soon as the group splits, or a pitch change leaves the audible partials
+ * between two mip levels — each partial picks up at the phase it would have
+ * reached, so synthesis continues seamlessly per partial.
+ *
+ * Spectral filter mode: because the signal is purely additive, a linear SVF
+ * is applied by scaling each partial by the filter's magnitude response at
+ * its frequency (SvfKernel::magnitude), evaluated once per sub-block and
+ * ramped per sample — no time-domain filter runs at all. Only the native
+ * SVF modes qualify (KAWAII_NATIVE_SVF builds); every other type keeps the
+ * time-domain path.
+ *
+ * The filter (and only the filter) can run 2× or 4× oversampled: each
+ * sub-block is upsampled through KawaiiHalfBand.h, filtered at the high
+ * rate, and decimated back — the oscillators stay at the host rate.
+ *
+ * Multi-rate partials (optional, CPU path): partials below kLowBandEdge·sr
+ * are synthesized at half the host rate — oscillator phase and envelope
+ * taken at every other sample — summed into one low band per voice and
+ * interpolated back up through the same half-band design. Only the partials
+ * above the edge run at the full rate. The split is fixed per note, with
+ * headroom for the highest pitch a bend can reach.
+ *
+ * Pitch: a note's pitch comes from the tuning table at note-on; pitch bend
+ * and Master Tune arrive as one control-rate offset for the whole bank
+ * (setPitchOffset). The partial increments are k × the fundamental's, kept
+ * in one contiguous array, so an offset change is a single vectorized
+ * integer multiply per voice (KernelTable::harmonicIncrements) — no
+ * per-partial pow().
+ *
+ * Modulation: the processor's ModulationEngine (KawaiiModulation.h)
+ * evaluates LFOs, velocity, note and mod wheel through the mod matrix at
+ * control rate, for all voices at once. A voice reads its lane once per
+ * filter sub-block — cutoff ratio, resonance offset, pitch — and ramps the
+ * level gain per sample through the filter packing, so nothing modulates
+ * per sample beyond that one multiply.
  *
  * Coefficient interpolation is handled by the library: coefficients
  * are computed once per 32-sample sub-block, then linearly interpolated
@@ -25,9 +75,17 @@
 #include <cmath>
 #include <algorithm>
 #include <array>
+#include <cstdint>
 #include <vector>
 #include "../entry/KawaiiCids.h"
 #include "../params/KawaiiFilterTypes.h"
+#include "KawaiiFilterKernels.h"
+#include "KawaiiHalfBand.h"
+#include "KawaiiWavetable.h"
+#include "KawaiiSharedTables.h"
+#include "KawaiiPhase.h"
+#include "KawaiiKernels.h"
+#include "KawaiiModulation.h"
 
 namespace Steinberg {
 namespace Vst {
@@ -36,6 +94,99 @@ namespace Kawaii {
 // Sub-block size for filter coefficient updates — matches Surge XT's BLOCK_SIZE.
 // Coefficients recomputed every 32 samples (~0.7ms at 44.1kHz, ~1378×/sec).
 static constexpr int kFilterBlockSize = 32;
+static_assert(ModulationEngine::kTickSize == kFilterBlockSize,
+              "modulation ticks are the filter's sub-blocks");
+static_assert(kFilterBlockSize <= kMaxPartialSegment,
+              "partialGroups renders whole filter sub-blocks");
+
+// Quality governor, partial culling: a partial whose level × envelope is
+// below this (−60 dB) is skipped for the segment (its phase still advances)
+static constexpr double kCullLevel = 0.001;
+
+// Multi-rate partials: highest partial frequency (× host rate) rendered at
+// half rate. Stays inside the steep half-band's passband (0.21·sr), so the
+// low band keeps its level and its images land in the stopband.
+static constexpr double kLowBandEdge = 0.2;
+
+// Largest delay line (per SIMD lane) any filter table entry can ask for.
+// Walks the library's config lists — not realtime-safe; cached after the
+// first call.
+inline size_t maxFilterDelayLineSize()
+{
+    static const size_t size = [] {
+        size_t largest = 0;
+        for (const auto& entry : getFilterTypes())
+            for (const auto& cfg : sfpp::Filter::availableModelConfigurations(entry.model, true))
+                largest = std::max(largest, sfpp::Filter::requiredDelayLinesSizes(entry.model, cfg));
+        return largest;
+    }();
+    return size;
+}
+
+// Library model + configuration a filter table entry and subtype (0–3)
+// resolve to
+struct FilterConfigChoice
+{
+    sfpp::FilterModel model;
+    sfpp::ModelConfig config;
+};
+
+// Resolving walks the library's config lists, which allocate, so every
+// type × subtype is resolved together on the first call (a voice's
+// constructor, at activation) and configureFilter() only looks them up.
+inline const FilterConfigChoice& filterConfigChoice(int typeIndex, int subType)
+{
+    static constexpr int kSubTypes = 4;
+    static const auto choices = [] {
+        std::array<std::array<FilterConfigChoice, kSubTypes>, kNumFilterTypes> table {};
+        const auto& types = getFilterTypes();
+        for (int t = 0; t < kNumFilterTypes; t++)
+        {
+            const auto& entry = types[(size_t)t];
+
+            // All valid configurations for this model (sorted for determinism),
+            // narrowed to our passband (unless the entry is UNSUPPORTED = don't
+            // care) and, for Comb filters, slope — so no config from another
+            // passband can be picked
+            auto allConfigs = sfpp::Filter::availableModelConfigurations(entry.model, true);
+            std::vector<sfpp::ModelConfig> matching;
+            for (const auto& cfg : allConfigs)
+            {
+                if (entry.passband != sfpp::Passband::UNSUPPORTED && cfg.pt != entry.passband)
+                    continue;
+                if (entry.slope != sfpp::Slope::UNSUPPORTED && cfg.st != sfpp::Slope::UNSUPPORTED
+                    && cfg.st != entry.slope)
+                    continue;
+                matching.push_back(cfg);
+            }
+
+            for (int sub = 0; sub < kSubTypes; sub++)
+            {
+                auto& choice = table[(size_t)t][(size_t)sub];
+                choice.model = entry.model;
+                if (!matching.empty())
+                {
+                    // The subtype selects among the matches
+                    choice.config = matching[(size_t)(sub % (int)matching.size())];
+                }
+                else if (!allConfigs.empty())
+                {
+                    // Shouldn't happen: the library's closest valid config
+                    sfpp::ModelConfig desired(entry.passband, entry.slope, entry.drive, entry.submodel);
+                    choice.config = sfpp::closestValidModelTo(entry.model, desired);
+                }
+                else
+                {
+                    // No configs at all — SVF LP
+                    choice.model = sfpp::FilterModel::CytomicSVF;
+                    choice.config = sfpp::ModelConfig(sfpp::Passband::LP);
+                }
+            }
+        }
+        return table;
+    }();
+    return choices[(size_t)std::clamp(typeIndex, 0, kNumFilterTypes - 1)][(size_t)std::clamp(subType, 0, kSubTypes - 1)];
+}
 
 // ============================================================================
 // ADSR Envelope — Analog RC-style curves
@@ -70,6 +221,11 @@ public:
         decayCoeff = 1.0 - std::exp(-1.0 / (seconds * sampleRate));
     }
 
+    // Precomputed coefficients (SharedTables::envelopeCoeff)
+    void setAttackCoeff(double c)  { attackCoeff = c; }
+    void setDecayCoeff(double c)   { decayCoeff = c; }
+    void setReleaseCoeff(double c) { releaseCoeff = c; }
+
     void setSustain(double level)
     {
         sustainLevel = std::clamp(level, 0.0, 1.0);
@@ -127,8 +283,18 @@ public:
     }
 
     bool isActive() const { return stage != Idle; }
+    bool isAttacking() const { return stage == Attack; }
+    bool isReleasing() const { return stage == Release; }
+    double getValue() const { return currentValue; }
     void reset() { stage = Idle; currentValue = 0.0; }
 
+    // Take over another envelope's position (stage + value), keeping our own times
+    void copyStateFrom(const ADSREnvelope& other)
+    {
+        stage = other.stage;
+        currentValue = other.currentValue;
+    }
+
 private:
     Stage  stage;
     double currentValue;
@@ -175,48 +341,65 @@ private:
 
 // ============================================================================
 // Partial — one sine oscillator + its own ADSR + level
+//
+// The envelope is only run when this partial leads its envelope group;
+// otherwise it is dormant and the leader's envelope applies. The oscillator
+// itself is rendered by the voice (renderPartials / the GPU). Phase is
+// fixed-point (KawaiiPhase.h); the increments live in the voice
+// (KawaiiVoice::getIncrement), 0 for a muted partial.
 // ============================================================================
 
 struct Partial
 {
-    double phase = 0.0;
-    double frequency = 0.0;
+    uint32_t phase = 0;
     double level = 1.0;
     ADSREnvelope envelope;
 
-    double process(double sampleRate)
+    void reset()
     {
-        if (!envelope.isActive())
-            return 0.0;
+        phase = 0;
+        envelope.reset();
+    }
+};
 
-        double envValue = envelope.process();
-        double output = std::sin(2.0 * M_PI * phase) * level * envValue;
+// ============================================================================
+// EnvelopeGroups — partition of partials by identical ADSR settings
+//
+// Computed by the processor at parameter-update time and shared by all voices.
+// leader[g] is the lowest partial index in group g. generation changes
+// whenever the partition does, so voices can skip re-applying it.
+// ============================================================================
 
-        phase += frequency / sampleRate;
-        if (phase >= 1.0)
-            phase -= 1.0;
+template <int NumPartials>
+struct EnvelopeGroups
+{
+    static_assert(NumPartials <= 256, "group indices are 8-bit");
 
-        return output;
-    }
+    std::array<uint8_t, NumPartials> groupOf {};
+    std::array<uint8_t, NumPartials> leader {};
+    int numGroups = 0;
+    uint32_t generation = 0;
 
-    void reset()
+    bool samePartition(const EnvelopeGroups& other) const
     {
-        phase = 0.0;
-        envelope.reset();
+        return numGroups == other.numGroups && groupOf == other.groupOf;
     }
 };
 
 // ============================================================================
-// KawaiiVoice — 32 partials + Surge XT sst-filters
+// KawaiiVoice — NumPartials partials + Surge XT sst-filters
 //
 // Uses sst::filtersplusplus::Filter which wraps QuadFilterUnit (4-wide SIMD).
 // We use processMonoSample() — only voice 0 of the SIMD quad is active.
 // Coefficient interpolation is built into the library's per-sample processing.
 // ============================================================================
 
+template <int NumPartials>
 class KawaiiVoice
 {
 public:
+    static constexpr int kNumPartials = NumPartials;
+
     KawaiiVoice()
         : noteNumber(-1), velocity(0.0), sampleRate(44100.0)
         , cutoffSmoother(1.0), resoSmoother(0.0)
@@ -224,6 +407,15 @@ public:
         , currentFilterTypeIndex(-1), currentFilterSubType(-1)
         , filterBlockPos(0)
     {
+        // Until the processor supplies groups: one envelope per partial
+        for (int i = 0; i < NumPartials; i++)
+        {
+            envGroupOf[(size_t)i] = static_cast<uint8_t>(i);
+            envGroupLeader[(size_t)i] = static_cast<uint8_t>(i);
+        }
+        numEnvGroups = NumPartials;
+        rebuildGroupMembers();
+
         // Default filter: SVF LP (index 0)
         configureFilter(0, 0);
     }
@@ -237,34 +429,84 @@ public:
         cutoffSmoother.setSampleRate(sr);
         resoSmoother.setSampleRate(sr);
 
-        // Set the filter's sample rate and sub-block size.
-        // The library uses this for coefficient delta computation:
-        // dC[i] = (targetC[i] - currentC[i]) / blockSize
-        filter.setSampleRateAndBlockSize(sr, kFilterBlockSize);
+        // Set the filter's sample rate and sub-block size (at the
+        // oversampled rate). The library uses this for coefficient delta
+        // computation: dC[i] = (targetC[i] - currentC[i]) / blockSize
+        applyFilterRate();
     }
 
-    void noteOn(int note, double vel)
+    // 12-TET note
+    void noteOn(int note, double vel) { noteOn(note, vel, static_cast<double>(note)); }
+
+    // pitch: the note's tuned pitch in semitones (69 = A4 at 440 Hz), before
+    // the bank's pitch offset
+    void noteOn(int note, double vel, double pitch)
     {
+        // Envelopes retrigger from their current value: bring every dormant
+        // envelope up to its leader's position, then take the current groups
+        // as they are (merging is only safe here, never mid-note)
+        for (int i = 0; i < NumPartials; i++)
+        {
+            int lead = envGroupLeader[envGroupOf[(size_t)i]];
+            if (lead != i)
+                partials[(size_t)i].envelope.copyStateFrom(partials[(size_t)lead].envelope);
+        }
+        if (envelopeGroups)
+        {
+            envGroupOf = envelopeGroups->groupOf;
+            envGroupLeader = envelopeGroups->leader;
+            numEnvGroups = envelopeGroups->numGroups;
+            appliedGroupGeneration = envelopeGroups->generation;
+            rebuildGroupMembers();
+        }
+
         noteNumber = note;
+        notePitch = pitch;
         velocity = vel;
 
-        double fundamental = 440.0 * std::pow(2.0, (note - 69) / 12.0);
-        double nyquist = sampleRate / 2.0;
+        // 12-TET pitches come from the shared tables; tuned ones are computed
+        noteHz = (tables && pitch == static_cast<double>(note))
+                     ? tables->noteFrequency(note)
+                     : 440.0 * std::pow(2.0, (pitch - 69.0) / 12.0);
 
-        for (int i = 0; i < kMaxPartials; i++)
+        for (auto& p : partials)
         {
-            double freq = fundamental * (i + 1);
-            partials[i].frequency = (freq < nyquist) ? freq : 0.0;
-            partials[i].phase = 0.0;
-            partials[i].envelope.noteOn();
+            p.phase = 0;
+            p.envelope.noteOn();
         }
 
+        // All partials share one envelope: render from the wavetable
+        collapsed = (wavetable != nullptr && numEnvGroups == 1 && !spectralActive);
+        tablePhase = 0;
+
+        audiblePartials = 0;
+        updateIncrements();
+        tanHalfStale = true;
+        spectralPrimed = false;
+
+        // Harmonics rise with the index, so the low band is a prefix. Sized
+        // for the highest fundamental the current bend range can reach, so
+        // no low-band partial is ever bent past the half-rate band.
+        lowBandPartials = 0;
+        if (multiRateRequested)
+        {
+            const double highest = noteHz * maxPitchRatio;
+            while (lowBandPartials < audiblePartials
+                   && highest * (lowBandPartials + 1) < kLowBandEdge * sampleRate)
+                lowBandPartials++;
+        }
+        lowBandUpsampler.reset();
+        hasLowBandCarry = false;
+
         filterEnvelope.noteOn();
         // Reset all SIMD voice filter registers without losing sampleRate.
         // All 4 voices are active (not using setMono), so reset all of them
         // to prevent stale state from the previous note bleeding through.
         for (int v = 0; v < 4; v++)
             filter.resetVoice(v);
+        svf.reset();
+        svf.unprime();
+        oversampler.reset();
         cutoffSmoother.snap();
         resoSmoother.snap();
         filterBlockPos = 0;   // Reset sub-block position
@@ -277,58 +519,225 @@ public:
         filterEnvelope.noteOff();
     }
 
-    // CPU path: per-sample processing (no GPU)
-    void process(double* outLeft, double* outRight)
+    // CPU path: render numSamples of this voice and ADD them to out.
+    //
+    // Works in segments aligned to the filter's kFilterBlockSize grid
+    // (filterBlockPos carries across calls, so host block sizes need not be
+    // multiples of it). Each segment runs stage by stage, like Phase 3 of the
+    // GPU path: filter modulation, partial sum into a scratch buffer, one
+    // filter pass, then the add into out.
+    void renderBlock(float* out, int numSamples)
     {
-        // 1. Sum all partials
-        double sum = 0.0;
-        for (auto& p : partials)
-            sum += p.process(sampleRate);
+        int done = 0;
+        while (done < numSamples)
+        {
+            int len = std::min(kFilterBlockSize - filterBlockPos, numSamples - done);
+            renderSegment(len, done);
 
-        double sample = sum * velocity / static_cast<double>(kMaxPartials);
+            float* dst = out + done;
+            for (int s = 0; s < len; s++)
+                dst[s] += renderScratch[s];
+            done += len;
+        }
+    }
 
-        // 2. Apply sst-filter with sub-block coefficient updates
-        double envValue = filterEnvelope.process();
-        double smoothedNorm = cutoffSmoother.process();
-        double smoothedReso = resoSmoother.process();
+    bool isActive() const
+    {
+        for (int g = 0; g < numEnvGroups; g++)
+            if (groupEnvelope(g).isActive()) return true;
+        return false;
+    }
 
-        // At sub-block boundary: recompute filter coefficients
-        if (filterBlockPos == 0)
+    // Active, and every sounding envelope is in its release stage
+    bool isReleasing() const
+    {
+        bool any = false;
+        for (int g = 0; g < numEnvGroups; g++)
         {
-            double cutoffHz = computeEffectiveCutoff(smoothedNorm, envValue);
-            // Convert Hz to sst-filters note units: A440 = 0, each unit = 1 semitone
-            float noteVal = static_cast<float>(12.0 * std::log2(std::max(cutoffHz, 1.0) / 440.0));
-            float reso = static_cast<float>(std::clamp(smoothedReso, 0.0, 1.0));
-
-            // Make coefficients for ALL 4 SIMD voices (all active, matching library pattern)
-            for (int v = 0; v < 4; v++)
-                filter.makeCoefficients(v, noteVal, reso);
-            filter.prepareBlock();
+            const auto& envelope = groupEnvelope(g);
+            if (!envelope.isActive()) continue;
+            if (!envelope.isReleasing()) return false;
+            any = true;
         }
+        return any;
+    }
 
-        // Process through sst-filter (mono, voice 0 only)
-        float out = filter.processMonoSample(static_cast<float>(sample));
+    // Loudest group envelope × velocity (for voice shedding)
+    double getLoudness() const
+    {
+        double loudest = 0.0;
+        for (int g = 0; g < numEnvGroups; g++)
+            loudest = std::max(loudest, groupEnvelope(g).getValue());
+        return loudest * velocity;
+    }
 
-        filterBlockPos++;
-        if (filterBlockPos >= kFilterBlockSize)
+    // Silence the voice immediately
+    void kill()
+    {
+        for (auto& p : partials)
+            p.envelope.reset();
+        filterEnvelope.reset();
+    }
+
+    // --- Quality governor tiers ---
+    void setPartialCulling(bool enabled) { partialCulling = enabled; }
+    void setFastSine(bool enabled)       { fastSine = enabled; }
+
+    // Partials of group g with level (× spectral gain) below this are culled;
+    // 0 when culling is off. Never culls during attack — the envelope is on
+    // its way up, and a partial must not pop in a segment late.
+    double cullThreshold(int g) const
+    {
+        const auto& envelope = groupEnvelope(g);
+        if (!partialCulling || envelope.isAttacking())
+            return 0.0;
+        return kCullLevel / std::max(envelope.getValue(), 1e-9);
+    }
+
+    int getNoteNumber() const { return noteNumber; }
+    double getVelocity() const { return velocity; }
+
+    // --- Pitch (control rate) ---
+
+    // Bank-wide offset in semitones (bend + Master Tune) and its frequency
+    // ratio, computed once by the processor. A sounding voice rescales all
+    // partial increments at once; an idle one keeps it for its next note.
+    void setPitchOffset(double semitones, double ratio)
+    {
+        if (ratio == pitchRatio)
+            return;
+        pitchOffset = semitones;
+        pitchRatio = ratio;
+        if (isActive())
         {
-            filter.concludeBlock();
-            filterBlockPos = 0;
+            updateIncrements();
+            tanHalfStale = true;
         }
+    }
 
-        *outLeft  = static_cast<double>(out);
-        *outRight = static_cast<double>(out);
+    // Highest ratio the offset can reach (bend range up + Master Tune);
+    // sizes the multi-rate split from the next note-on
+    void setMaxPitchRatio(double ratio) { maxPitchRatio = ratio; }
+
+    // --- Modulation (control rate) ---
+
+    // The processor's engine; this voice reads lane `lane` (its bank index)
+    void setModulation(const ModulationEngine* engine, int lane)
+    {
+        modulation = engine;
+        modLane = lane;
     }
 
-    bool isActive() const
+    // Cutoff ratio and resonance offset at `offset` samples into the block.
+    // Once per filter sub-block, before computeEffectiveCutoff().
+    void applyFilterModulation(int offset)
     {
-        for (const auto& p : partials)
-            if (p.envelope.isActive()) return true;
-        return false;
+        if (!modulation)
+            return;
+        modCutoffRatio = modulation->routes(kModDestCutoff)
+                             ? modulation->valueAt(kModDestCutoff, modLane, offset) : 1.0;
+        modResonance = modulation->routes(kModDestResonance)
+                           ? modulation->valueAt(kModDestResonance, modLane, offset) : 0.0;
     }
 
-    int getNoteNumber() const { return noteNumber; }
-    double getVelocity() const { return velocity; }
+    // Pitch modulation at `offset`: like a bank offset change, one
+    // increment pass — and only when the value moved
+    void applyPitchModulation(int offset)
+    {
+        if (!modulation)
+            return;
+        double semitones = modulation->routes(kModDestPitch)
+                               ? modulation->valueAt(kModDestPitch, modLane, offset) : 0.0;
+        if (semitones == modPitch)
+            return;
+        modPitch = semitones;
+        modPitchRatio = std::exp2(semitones / 12.0);
+        updateIncrements();
+        tanHalfStale = true;
+    }
+
+    // Gain on all partial levels at `offset` (1 when unrouted)
+    double levelModulation(int offset) const
+    {
+        return (modulation && modulation->routes(kModDestLevel))
+                   ? modulation->valueAt(kModDestLevel, modLane, offset) : 1.0;
+    }
+
+    // Filter Reso plus its modulation
+    double effectiveResonance(double smoothedReso) const
+    {
+        return std::clamp(smoothedReso + modResonance, 0.0, 1.0);
+    }
+
+    // Per-sample fixed-point phase increment of partial p (0 = muted)
+    uint32_t getIncrement(int p) const { return increments[(size_t)p]; }
+
+    // Shared harmonic wavetable, or nullptr when the partial envelopes differ
+    // (or the GPU renders the partials). Used from the next note-on; clearing
+    // it expands a collapsed voice back to per-partial synthesis immediately.
+    void setWavetable(const HarmonicWavetable<NumPartials>* table)
+    {
+        wavetable = table;
+        if (!table && collapsed)
+            expandPartials();
+    }
+
+    bool isCollapsed() const { return collapsed; }
+
+    // Shared envelope grouping (owned by the processor's voice bank). Taken
+    // as is at the next note-on; mid-note, groups can only split — partials
+    // following different envelopes have different states and cannot be
+    // merged — so the voice refines its current groups by the new partition.
+    // A dormant partial that becomes a leader inherits its old leader's state.
+    void setEnvelopeGroups(const EnvelopeGroups<NumPartials>* groups)
+    {
+        envelopeGroups = groups;
+        if (!groups || groups->generation == appliedGroupGeneration)
+            return;
+        appliedGroupGeneration = groups->generation;
+
+        std::array<uint8_t, NumPartials> oldLeader;
+        for (int i = 0; i < NumPartials; i++)
+            oldLeader[(size_t)i] = envGroupLeader[envGroupOf[(size_t)i]];
+
+        int n = 0;
+        for (int i = 0; i < NumPartials; i++)
+        {
+            int lead = i;
+            for (int j = 0; j < i; j++)
+            {
+                if (oldLeader[(size_t)j] == oldLeader[(size_t)i]
+                    && groups->groupOf[(size_t)j] == groups->groupOf[(size_t)i])
+                {
+                    lead = j;
+                    break;
+                }
+            }
+
+            if (lead == i)
+            {
+                if (oldLeader[(size_t)i] != i)
+                    partials[(size_t)i].envelope.copyStateFrom(partials[oldLeader[(size_t)i]].envelope);
+                envGroupLeader[(size_t)n] = static_cast<uint8_t>(i);
+                envGroupOf[(size_t)i] = static_cast<uint8_t>(n++);
+            }
+            else
+            {
+                envGroupOf[(size_t)i] = envGroupOf[(size_t)lead];
+            }
+        }
+        numEnvGroups = n;
+        rebuildGroupMembers();
+
+        if (collapsed && numEnvGroups > 1)
+            expandPartials();
+    }
+
+    // --- Envelope groups (GPU preparation walks these) ---
+    int getNumEnvelopeGroups() const { return numEnvGroups; }
+    int envelopeGroupOf(int partial) const { return envGroupOf[(size_t)partial]; }
+    ADSREnvelope& groupEnvelope(int g) { return partials[envGroupLeader[(size_t)g]].envelope; }
+    const ADSREnvelope& groupEnvelope(int g) const { return partials[envGroupLeader[(size_t)g]].envelope; }
 
     // --- Filter parameter setters ---
     void setFilterCutoffNorm(double norm) { cutoffSmoother.setTarget(norm); }
@@ -336,10 +745,86 @@ public:
     void setFilterEnvDepth(double depth) { filterEnvDepth = depth; }
     void setFilterKeytrack(double amt)   { filterKeytrack = amt; }
 
-    void setFilterEnvAttack(double sec)  { filterEnvelope.setAttack(sec); }
-    void setFilterEnvDecay(double sec)   { filterEnvelope.setDecay(sec); }
-    void setFilterEnvSustain(double lvl) { filterEnvelope.setSustain(lvl); }
-    void setFilterEnvRelease(double sec) { filterEnvelope.setRelease(sec); }
+    void setFilterEnvAttackCoeff(double c)  { filterEnvelope.setAttackCoeff(c); }
+    void setFilterEnvDecayCoeff(double c)   { filterEnvelope.setDecayCoeff(c); }
+    void setFilterEnvSustain(double lvl)    { filterEnvelope.setSustain(lvl); }
+    void setFilterEnvReleaseCoeff(double c) { filterEnvelope.setReleaseCoeff(c); }
+
+    // Process-wide tables for the current sample rate (owned by the processor)
+    void setSharedTables(const SharedTables* t) { tables = t; }
+
+    // Comb filter delay lines: a region of the processor's arena holding
+    // maxFilterDelayLineSize() floats for each of the 4 SIMD lanes.
+    // Re-applies the current filter so it picks the storage up.
+    void setDelayLineStorage(float* memory, size_t capacity)
+    {
+        delayLineMemory = memory;
+        delayLineCapacity = memory ? capacity : 0;
+        if (currentFilterTypeIndex >= 0)
+            configureFilter(currentFilterTypeIndex, currentFilterSubType);
+    }
+
+    // Bytes of this voice's filter state, for memory accounting. The delay
+    // lines are not in it — they live in the processor's arena.
+    static constexpr size_t filterStateBytes()
+    {
+        return sizeof(filter) + sizeof(svf) + sizeof(oversampler);
+    }
+
+    // Filter oversampling factor (1, 2 or 4). Only re-rates the filter when
+    // the factor actually changes.
+    void setFilterOversampling(int factor)
+    {
+        if (factor == oversampler.getFactor())
+            return;
+
+        oversampler.setFactor(factor);
+        applyFilterRate();
+        svf.reset();
+        svf.unprime();
+        for (int v = 0; v < 4; v++)
+            filter.resetVoice(v);
+    }
+
+    // Multi-rate partial rendering (CPU path), from the next note-on
+    void setMultiRatePartials(bool enabled) { multiRateRequested = enabled; }
+
+    // Spectral filter mode (takes effect only for native SVF types)
+    void setSpectralFilter(bool enabled)
+    {
+        if (enabled == spectralRequested)
+            return;
+        spectralRequested = enabled;
+        updateSpectralMode();
+    }
+
+    bool usesSpectralFilter() const { return spectralActive; }
+
+    // Spectral mode, GPU path: advance the filter modulation over numSamples
+    // and ramp the partial gains towards the response at the end of the span.
+    // Read the ramps with getSpectralGain/Delta, then concludeSpectralBlock().
+    void prepareSpectralBlock(int numSamples)
+    {
+        double envValue = 0.0, smoothedNorm = 0.0, smoothedReso = 0.0;
+        for (int s = 0; s < numSamples; s++)
+        {
+            envValue     = filterEnvelope.process();
+            smoothedNorm = cutoffSmoother.process();
+            smoothedReso = resoSmoother.process();
+        }
+        setSpectralTargets(computeEffectiveCutoff(smoothedNorm, envValue), effectiveResonance(smoothedReso),
+                           numSamples);
+    }
+
+    float getSpectralGain(int partial) const  { return spectralGain[(size_t)partial]; }
+    float getSpectralDelta(int partial) const { return spectralDelta[(size_t)partial]; }
+
+    // End of a spectral span: snap gains to target so rounding never accumulates
+    void concludeSpectralBlock()
+    {
+        spectralGain = spectralTarget;
+        spectralDelta.fill(0.0f);
+    }
 
     // Configure the sst-filter from our type index + subtype.
     // Only calls prepareInstance() when the type actually changes.
@@ -369,16 +854,25 @@ public:
     // Compute effective cutoff Hz from smoothed normalized cutoff + modulation
     double computeEffectiveCutoff(double smoothedNorm, double envValue) const
     {
-        double baseCutoffHz = 20.0 * std::pow(1000.0, smoothedNorm);
+        double baseCutoffHz = tables ? tables->cutoffHz(smoothedNorm)
+                                     : 20.0 * std::pow(1000.0, smoothedNorm);
         double envMod = filterEnvDepth * envValue * 10000.0;
-        double keyMod = filterKeytrack * (noteNumber - 60) * 100.0;
-        return std::clamp(baseCutoffHz + envMod + keyMod, 20.0, 20000.0);
+        double keyMod = filterKeytrack * (notePitch + pitchOffset + modPitch - 60.0) * 100.0;
+        return std::clamp((baseCutoffHz + envMod + keyMod) * modCutoffRatio, 20.0, 20000.0);
     }
 
-    // --- Sub-block coefficient interpolation for GPU path ---
+    // --- Sub-block coefficient interpolation ---
     // Called once per sub-block with the target cutoff and resonance.
     void prepareFilterBlock(double cutoffHz, double reso)
     {
+        if (useNativeSvf)
+        {
+            int os = oversampler.getFactor();
+            svf.setTarget(cutoffHz, reso, sampleRate * os, kFilterBlockSize * os);
+            return;
+        }
+
+        // Convert Hz to sst-filters note units: A440 = 0, each unit = 1 semitone
         float noteVal = static_cast<float>(12.0 * std::log2(std::max(cutoffHz, 1.0) / 440.0));
         float r = static_cast<float>(std::clamp(reso, 0.0, 1.0));
 
@@ -388,30 +882,473 @@ public:
         filter.prepareBlock();
     }
 
-    // Process one sample through the filter (call exactly kFilterBlockSize times
-    // after prepareFilterBlock, then call concludeFilterBlock).
-    float filterBlockStep(float sample)
+    // Filter n samples in place (at most kFilterBlockSize per sub-block,
+    // between prepareFilterBlock and concludeFilterBlock).
+    void filterBlock(float* io, int n)
     {
-        return filter.processMonoSample(sample);
+        oversampler.process(io, n, [this](float* buf, int len) {
+            filterBlockFn(*this, buf, len);
+        });
     }
 
     // End the current sub-block (call after kFilterBlockSize samples processed)
     void concludeFilterBlock()
     {
-        filter.concludeBlock();
+        if (useNativeSvf)
+            svf.conclude();
+        else
+            filter.concludeBlock();
     }
 
     // Public so the processor can set per-partial ADSR and level directly
-    std::array<Partial, kMaxPartials> partials;
+    std::array<Partial, NumPartials> partials;
 
 private:
     int    noteNumber;
     double velocity;
     double sampleRate;
+    const SharedTables* tables = nullptr;
+
+    // Pitch: the tuned note (semitones) and its frequency, the bank's offset,
+    // this voice's pitch modulation, and the partial increments for
+    // noteHz · pitchRatio · modPitchRatio. Harmonics [audiblePartials, N)
+    // are at or above Nyquist and muted.
+    double notePitch = 60.0;
+    double noteHz = 0.0;
+    double pitchOffset = 0.0;
+    double pitchRatio = 1.0;
+    double modPitch = 0.0;
+    double modPitchRatio = 1.0;
+    double maxPitchRatio = 1.0;
+    uint32_t fundamentalIncrement = 0;
+    int audiblePartials = 0;
+    std::array<uint32_t, NumPartials> increments {};
+
+    // Increments for the current pitch. Harmonic k advances exactly k
+    // fundamental increments, so partial phases stay exact multiples of the
+    // fundamental's (see expandPartials) through any number of changes.
+    void updateIncrements()
+    {
+        const double fundamental = noteHz * pitchRatio * modPitchRatio;
+        const int wasAudible = audiblePartials;
+
+        fundamentalIncrement = (fundamental < sampleRate / 2.0)
+                                   ? FixedPhase::increment(fundamental, sampleRate) : 0;
+        // k·inc < 2^31 (Nyquist) ⇔ k ≤ (2^31 − 1) / inc
+        audiblePartials = fundamentalIncrement
+                              ? static_cast<int>(std::min<uint32_t>(NumPartials, 0x7FFFFFFFu / fundamentalIncrement))
+                              : 0;
+        kernels->harmonicIncrements(increments.data(), NumPartials, fundamentalIncrement, audiblePartials);
+
+        // Partials crossing Nyquist: a muted one rests at phase 0 (its sine
+        // reads 0), one coming back joins at k·φ of the fundamental
+        for (int i = audiblePartials; i < wasAudible; i++)
+            partials[(size_t)i].phase = 0;
+        for (int i = wasAudible; i < audiblePartials; i++)
+            partials[(size_t)i].phase = partials[0].phase * static_cast<uint32_t>(i + 1);
+
+        // A collapsed voice needs a table with exactly the audible partials;
+        // between two mip levels it renders them one by one instead
+        if (collapsed)
+        {
+            wavetableLevel = wavetable->levelFor(audiblePartials);
+            tableIncrement = fundamentalIncrement;
+            if (!wavetableLevel)
+                expandPartials();
+        }
+    }
 
     // sst-filters++ Filter instance (wraps QuadFilterUnit + CoefficientMaker)
     sfpp::Filter filter;
 
+    // Native SVF kernel + the block loop selected for the current config.
+    // filterBlockFn is one of the instantiations below, fixed per config.
+    using FilterBlockFn = void (*)(KawaiiVoice&, float*, int);
+    SvfKernel svf;
+    bool useNativeSvf = false;
+    FilterBlockFn filterBlockFn = &libraryFilterBlock;
+
+    // Up/down resampling around the filter (factor 1 = bypass)
+    FilterOversampler<kFilterBlockSize> oversampler;
+
+    // One segment (≤ the rest of the current sub-block) into renderScratch;
+    // it starts `offset` samples into the processor's block
+    void renderSegment(int len, int offset)
+    {
+        // 1. Filter and pitch modulation. Coefficients (or spectral gains)
+        //    come from the sub-block's first sample; the rest of it just
+        //    advances state.
+        int s0 = 0;
+        if (filterBlockPos == 0)
+        {
+            applyPitchModulation(offset);
+            applyFilterModulation(offset);
+
+            double envValue = filterEnvelope.process();
+            double smoothedNorm = cutoffSmoother.process();
+            double reso = effectiveResonance(resoSmoother.process());
+
+            double cutoffHz = computeEffectiveCutoff(smoothedNorm, envValue);
+            if (spectralActive)
+                setSpectralTargets(cutoffHz, reso, kFilterBlockSize);
+            else
+                prepareFilterBlock(cutoffHz, reso);
+            s0 = 1;
+        }
+        for (int s = s0; s < len; s++)
+        {
+            filterEnvelope.process();
+            cutoffSmoother.process();
+            resoSmoother.process();
+        }
+
+        // 2. Partial sum (or the collapsed wavetable)
+        double sum[kFilterBlockSize];
+        if (collapsed)
+            renderWavetable(sum, len);
+        else
+            renderPartials(sum, len);
+
+        // Level modulation rides on the packing scale as a per-sample ramp
+        double scale = velocity / static_cast<double>(NumPartials);
+        double dScale = 0.0;
+        if (modulation && modulation->routes(kModDestLevel))
+        {
+            double g0 = levelModulation(offset);
+            dScale = scale * (levelModulation(offset + len) - g0) / len;
+            scale *= g0;
+        }
+        kernels->packScaled(renderScratch, sum, len, scale, dScale);
+
+        // 3. Time-domain filter (already in the partial gains in spectral mode)
+        if (!spectralActive)
+            filterBlock(renderScratch, len);
+
+        filterBlockPos += len;
+        if (filterBlockPos >= kFilterBlockSize)
+        {
+            if (spectralActive)
+                concludeSpectralBlock();
+            else
+                concludeFilterBlock();
+            filterBlockPos = 0;
+        }
+    }
+
+    void renderWavetable(double* sum, int len)
+    {
+        auto& envelope = partials[0].envelope;  // leader of the only group
+        for (int s = 0; s < len; s++)
+        {
+            double envValue = envelope.process();
+            sum[s] = HarmonicWavetable<NumPartials>::read(wavetableLevel, tablePhase) * envValue;
+            tablePhase += tableIncrement;
+        }
+    }
+
+    // Per envelope group: sum the members' oscillators over the segment, then
+    // scale by the group's envelope. Oscillator loops use closed-form phase
+    // (φ0 + s·inc, wrapping in fixed point) so they carry no loop dependency
+    // and vectorize.
+    //
+    // The voice only lists the work — each sounding partial as a PartialJob,
+    // each group's envelope — and one kernel call per batch of up to
+    // kGroupBatch groups renders it, so the oscillator loops run inside the
+    // ISA's own code rather than one indirect call per partial.
+    //
+    // Low-band partials (multi-rate) only produce every other sample: low
+    // sample j sits at segment position lowPos0 + 2j, where lowPos0 skips the
+    // sample still owed from the previous segment's upsampled pair.
+    void renderPartials(double* sum, int len)
+    {
+        std::fill(sum, sum + len, 0.0);
+
+        const int lowPos0 = hasLowBandCarry ? 1 : 0;
+        const int numLow = (lowBandPartials > 0) ? (len - lowPos0 + 1) / 2 : 0;
+        double lowSum[kMaxLowSamples] = {};
+
+        std::array<PartialJob, NumPartials> jobs;
+        PartialGroup batch[kGroupBatch];
+        double env[kGroupBatch][kFilterBlockSize];
+        int numJobs = 0, numBatched = 0;
+        auto renderBatch = [&] {
+            kernels->partialGroups[spectralActive][fastSine](sum, lowSum, len, numLow, lowPos0,
+                                                             jobs.data(), batch, numBatched);
+            numJobs = numBatched = 0;
+        };
+
+        for (int g = 0; g < numEnvGroups; g++)
+        {
+            auto& envelope = groupEnvelope(g);
+            if (!envelope.isActive())
+                continue;
+
+            // Members are in ascending partial order, so the low-band ones
+            // (below lowBandPartials) come first, as PartialGroup wants
+            PartialGroup& group = batch[numBatched];
+            group = { numJobs, 0, 0, env[numBatched] };
+            const double cullBelow = cullThreshold(g);
+            for (int m = groupFirst[(size_t)g]; m < groupFirst[(size_t)g + 1]; m++)
+            {
+                int i = groupMembers[(size_t)m];
+                auto& p = partials[(size_t)i];
+                const uint32_t phase0 = p.phase;
+                const uint32_t inc = increments[(size_t)i];
+                const double level = p.level;
+                const double gain0 = spectralActive ? spectralGain[(size_t)i] : 1.0;
+                const double dGain = spectralActive ? spectralDelta[(size_t)i] : 0.0;
+
+                // A culled partial only advances its phase (and gain ramp)
+                if (level * gain0 >= cullBelow)
+                {
+                    if (i < lowBandPartials)
+                    {
+                        jobs[(size_t)numJobs++] = { phase0 + static_cast<uint32_t>(lowPos0) * inc, 2 * inc,
+                                                    level, gain0 + lowPos0 * dGain, 2.0 * dGain };
+                        group.numLowJobs++;
+                    }
+                    else
+                    {
+                        jobs[(size_t)numJobs++] = { phase0, inc, level, gain0, dGain };
+                        group.numFullJobs++;
+                    }
+                }
+
+                if (spectralActive)
+                    spectralGain[(size_t)i] = static_cast<float>(gain0 + len * dGain);
+                p.phase = phase0 + static_cast<uint32_t>(len) * inc;
+            }
+
+            // ADSR is sequential/stateful — one pass per group, not per partial
+            for (int s = 0; s < len; s++)
+                env[numBatched][s] = envelope.process();
+
+            if (++numBatched == kGroupBatch)
+                renderBatch();
+        }
+        if (numBatched > 0)
+            renderBatch();
+
+        if (lowBandPartials > 0)
+            mixLowBand(sum, len, lowSum, numLow);
+    }
+
+    // Interpolate numLow low-band samples to the full rate and add them to
+    // sum: first the sample owed from the previous segment, then two per low
+    // sample. An odd one out is owed to the next segment.
+    void mixLowBand(double* sum, int len, const double* lowSum, int numLow)
+    {
+        float low[kMaxLowSamples];
+        float up[kMaxLowSamples * 2];
+        for (int j = 0; j < numLow; j++)
+            low[j] = static_cast<float>(lowSum[j]);
+        lowBandUpsampler.process(low, up, numLow);
+
+        int s = 0;
+        if (hasLowBandCarry)
+            sum[s++] += lowBandCarry;
+
+        int u = 0;
+        for (; s < len; s++)
+            sum[s] += up[u++];
+
+        hasLowBandCarry = u < numLow * 2;
+        if (hasLowBandCarry)
+            lowBandCarry = up[u];
+    }
+
+    // Partials listed group by group (counting sort of envGroupOf):
+    // members of group g are groupMembers[groupFirst[g] … groupFirst[g+1])
+    void rebuildGroupMembers()
+    {
+        std::array<uint16_t, NumPartials + 1> next {};
+        for (int i = 0; i < NumPartials; i++)
+            next[(size_t)envGroupOf[(size_t)i] + 1]++;
+        for (int g = 0; g < numEnvGroups; g++)
+            next[(size_t)g + 1] += next[(size_t)g];
+
+        groupFirst = next;
+        for (int i = 0; i < NumPartials; i++)
+            groupMembers[next[envGroupOf[(size_t)i]]++] = static_cast<uint8_t>(i);
+    }
+
+    // Segment output for renderBlock()
+    alignas(16) float renderScratch[kFilterBlockSize] = {};
+
+    // This CPU's widest kernels (oscillator, envelope, filter packing)
+    const KernelTable* kernels = &activeKernels();
+
+    // Modulation engine lane, and the values last read from it
+    const ModulationEngine* modulation = nullptr;
+    int modLane = 0;
+    double modCutoffRatio = 1.0;
+    double modResonance = 0.0;
+
+    // Quality governor tiers (set by the processor)
+    bool partialCulling = false;
+    bool fastSine = false;
+
+    // Multi-rate partials: partials [0, lowBandPartials) render at half rate
+    // for the current note. The upsampler emits pairs, so a segment ending
+    // mid-pair leaves lowBandCarry for the next one.
+    static constexpr int kMaxLowSamples = kFilterBlockSize / 2 + 1;
+
+    // Envelope groups per partialGroups call (bounds the envelope buffer
+    // renderPartials keeps on the stack)
+    static constexpr int kGroupBatch = 16;
+    bool multiRateRequested = false;
+    int lowBandPartials = 0;
+    HalfBandUpsampler<10> lowBandUpsampler { HalfBandDesign::steepCoefs().data() };
+    float lowBandCarry = 0.0f;
+    bool hasLowBandCarry = false;
+
+    // Spectral filter mode: per-partial gains (current, per-sample delta,
+    // target) from the SVF magnitude at tan(π·f_k/sr), which changes with the
+    // note and the pitch offset (refreshed lazily, only if spectral reads it)
+    bool spectralRequested = false;
+    bool spectralActive = false;
+    bool spectralPrimed = false;
+    bool tanHalfStale = true;
+    SvfMode svfMode = SvfMode::LP;
+    std::array<double, NumPartials> partialTanHalf {};
+    std::array<float, NumPartials> spectralGain {};
+    std::array<float, NumPartials> spectralDelta {};
+    std::array<float, NumPartials> spectralTarget {};
+
+    // The shared per-note table covers 12-TET notes without an offset; bent
+    // or retuned pitches compute their own tan() — once per change, per voice
+    void refreshTanHalf()
+    {
+        const double* noteTan = (tables && notePitch == static_cast<double>(noteNumber)
+                                 && pitchRatio == 1.0 && modPitchRatio == 1.0)
+                                    ? tables->partialTanHalf(noteNumber) : nullptr;
+        const double fundamental = noteHz * pitchRatio * modPitchRatio;
+        for (int i = 0; i < NumPartials; i++)
+            partialTanHalf[(size_t)i] = noteTan ? noteTan[i]
+                                      : (i < audiblePartials) ? std::tan(M_PI * fundamental * (i + 1) / sampleRate)
+                                                              : 0.0;
+        tanHalfStale = false;
+    }
+
+    void setSpectralTargets(double cutoffHz, double reso, int rampLength)
+    {
+        if (tanHalfStale)
+            refreshTanHalf();
+
+        double g, k;
+        SvfKernel::computeGK(cutoffHz, reso, sampleRate, g, k);
+
+        for (int i = 0; i < NumPartials; i++)
+            spectralTarget[(size_t)i] = static_cast<float>(
+                SvfKernel::magnitude(svfMode, partialTanHalf[(size_t)i], g, k));
+
+        if (!spectralPrimed)
+        {
+            concludeSpectralBlock();
+            spectralPrimed = true;
+            return;
+        }
+
+        float inv = 1.0f / static_cast<float>(std::max(rampLength, 1));
+        for (int i = 0; i < NumPartials; i++)
+            spectralDelta[(size_t)i] = (spectralTarget[(size_t)i] - spectralGain[(size_t)i]) * inv;
+    }
+
+    // Re-evaluate after the request or the filter type changed. Both paths
+    // restart their sub-block so neither runs on the other's stale state.
+    void updateSpectralMode()
+    {
+        bool active = spectralRequested && useNativeSvf;
+        if (active == spectralActive)
+            return;
+
+        spectralActive = active;
+        spectralPrimed = false;
+        svf.reset();
+        svf.unprime();
+        filterBlockPos = 0;
+
+        if (spectralActive && collapsed)
+            expandPartials();
+    }
+
+    // Envelope groups in effect for this voice (a refinement of *envelopeGroups
+    // while a note is sounding)
+    const EnvelopeGroups<NumPartials>* envelopeGroups = nullptr;
+    uint32_t appliedGroupGeneration = 0;
+    std::array<uint8_t, NumPartials> envGroupOf;
+    std::array<uint8_t, NumPartials> envGroupLeader;
+    int numEnvGroups;
+    std::array<uint8_t, NumPartials> groupMembers;
+    std::array<uint16_t, NumPartials + 1> groupFirst;
+
+    // Wavetable collapse (single envelope group). tablePhase is the
+    // fundamental's phase; the partials' own phases are stale meanwhile.
+    const HarmonicWavetable<NumPartials>* wavetable = nullptr;
+    const float* wavetableLevel = nullptr;
+    bool collapsed = false;
+    uint32_t tablePhase = 0;
+    uint32_t tableIncrement = 0;
+
+    // Leave the collapse: every partial takes the phase it would have reached
+    // (harmonic k is at k·φ — all partials start at phase 0 on note-on, and
+    // k·φ wraps exactly in fixed point).
+    // Envelope state is the groups' business (setEnvelopeGroups).
+    void expandPartials()
+    {
+        for (int i = 0; i < NumPartials; i++)
+        {
+            auto& p = partials[i];
+            p.phase = (increments[(size_t)i] != 0) ? tablePhase * static_cast<uint32_t>(i + 1) : 0;
+        }
+        collapsed = false;
+    }
+
+    void applyFilterRate()
+    {
+        int os = oversampler.getFactor();
+        filter.setSampleRateAndBlockSize(sampleRate * os, kFilterBlockSize * os);
+    }
+
+    template <SvfMode M>
+    static void nativeSvfBlock(KawaiiVoice& v, float* io, int n)
+    {
+        v.svf.template process<M>(io, n);
+    }
+
+    static void libraryFilterBlock(KawaiiVoice& v, float* io, int n)
+    {
+        for (int i = 0; i < n; i++)
+            io[i] = v.filter.processMonoSample(io[i]);
+    }
+
+    void selectFilterKernel(const FilterTypeEntry& entry)
+    {
+        SvfMode mode;
+        useNativeSvf = kNativeSvf && nativeSvfModeFor(entry.model, entry.passband, mode);
+        if (!useNativeSvf)
+        {
+            filterBlockFn = &libraryFilterBlock;
+            updateSpectralMode();
+            return;
+        }
+        svfMode = mode;
+
+        switch (mode)
+        {
+            case SvfMode::LP:      filterBlockFn = &nativeSvfBlock<SvfMode::LP>;      break;
+            case SvfMode::HP:      filterBlockFn = &nativeSvfBlock<SvfMode::HP>;      break;
+            case SvfMode::BP:      filterBlockFn = &nativeSvfBlock<SvfMode::BP>;      break;
+            case SvfMode::Notch:   filterBlockFn = &nativeSvfBlock<SvfMode::Notch>;   break;
+            case SvfMode::Peak:    filterBlockFn = &nativeSvfBlock<SvfMode::Peak>;    break;
+            case SvfMode::Allpass: filterBlockFn = &nativeSvfBlock<SvfMode::Allpass>; break;
+        }
+        svf.reset();
+        svf.unprime();
+        spectralPrimed = false;   // new mode, new response
+        updateSpectralMode();
+    }
+
     // Filter ADSR envelope and parameter smoothers
     ADSREnvelope filterEnvelope;
     ParamSmoother cutoffSmoother;
@@ -427,15 +1364,16 @@ private:
     int filterBlockPos;
 
     // Delay line memory for Comb filters (managed per-voice)
-    std::vector<float> delayLineMemory;
+    float* delayLineMemory = nullptr;
+    size_t delayLineCapacity = 0;   // floats, all 4 lanes
 
     // Configure the sst-filter from type table + subtype.
     //
-    // Uses availableModelConfigurations() to get the EXACT valid configs
-    // for the model, then filters to the desired passband/slope/drive from
-    // our filter type table. The subtype index selects among the remaining
-    // valid variants (cycling through different drive modes, slopes, or
-    // submodels depending on what the model supports).
+    // The library config comes from filterConfigChoice(): the EXACT valid
+    // configs for the model, filtered to the desired passband/slope from
+    // our filter type table, with the subtype index selecting among the
+    // remaining valid variants (cycling through different drive modes,
+    // slopes, or submodels depending on what the model supports).
     //
     // IMPORTANT: We keep all 4 SIMD voices active and make coefficients for
     // all 4. This matches the library test patterns and prevents undefined
@@ -449,71 +1387,36 @@ private:
 
         const auto& entry = types[(size_t)typeIndex];
 
-        // 1. Set the model
-        filter.setFilterModel(entry.model);
-
-        // 2. Get ALL valid configurations for this model (sorted for determinism)
-        auto allConfigs = sfpp::Filter::availableModelConfigurations(entry.model, true);
-
-        // 3. Filter to configs matching our desired passband (and slope if specified)
-        //    This gives us only configs that are actually valid for the passband
-        //    we want, avoiding cross-passband contamination.
-        std::vector<sfpp::ModelConfig> matching;
-        for (const auto& cfg : allConfigs)
-        {
-            // Must match passband (unless table entry is UNSUPPORTED = don't care)
-            if (entry.passband != sfpp::Passband::UNSUPPORTED && cfg.pt != entry.passband)
-                continue;
-
-            // For Comb filters: match slope (the primary dimension)
-            if (entry.slope != sfpp::Slope::UNSUPPORTED && cfg.st != sfpp::Slope::UNSUPPORTED
-                && cfg.st != entry.slope)
-                continue;
-
-            matching.push_back(cfg);
-        }
-
-        // 4. If we got matches, use the subtype index to select among them.
-        //    If no matches (shouldn't happen), fall back to all configs.
-        sfpp::ModelConfig chosen;
-        if (!matching.empty())
-        {
-            int idx = subType % (int)matching.size();
-            chosen = matching[(size_t)idx];
-        }
-        else if (!allConfigs.empty())
-        {
-            // Safety fallback: use closestValidModelTo with our desired config
-            sfpp::ModelConfig desired(entry.passband, entry.slope, entry.drive, entry.submodel);
-            chosen = sfpp::closestValidModelTo(entry.model, desired);
-        }
-        else
-        {
-            // No configs at all — fall back to SVF LP
-            filter.setFilterModel(sfpp::FilterModel::CytomicSVF);
-            chosen = sfpp::ModelConfig(sfpp::Passband::LP);
-        }
-
-        // 5. Set the validated configuration atomically
+        // 1–2. Set the model and the configuration resolved for this
+        //      type/subtype (filterConfigChoice — no allocation here)
+        const auto& choice = filterConfigChoice(typeIndex, subType);
+        const sfpp::ModelConfig& chosen = choice.config;
+        filter.setFilterModel(choice.model);
         filter.setModelConfiguration(chosen);
 
-        // 6. Allocate delay line memory for Comb filters (all 4 SIMD voices)
-        auto dlSize = sfpp::Filter::requiredDelayLinesSizes(entry.model, chosen);
+        // 3. Attach delay line memory for Comb filters (all 4 SIMD voices)
+        //    The storage is preallocated (setDelayLineStorage); without it
+        //    — before activation — the config falls back like a failed prepare.
+        auto dlSize = sfpp::Filter::requiredDelayLinesSizes(choice.model, chosen);
+        bool delayLinesOk = true;
         if (dlSize > 0)
         {
             // Need delay lines for all 4 SIMD voices since all are active
-            delayLineMemory.resize(dlSize * 4, 0.0f);
-            std::fill(delayLineMemory.begin(), delayLineMemory.end(), 0.0f);
-            for (int v = 0; v < 4; v++)
-                filter.provideDelayLine(v, delayLineMemory.data() + dlSize * v);
+            delayLinesOk = delayLineMemory && dlSize * 4 <= delayLineCapacity;
+            if (delayLinesOk)
+            {
+                std::fill(delayLineMemory, delayLineMemory + dlSize * 4, 0.0f);
+                for (int v = 0; v < 4; v++)
+                    filter.provideDelayLine(v, delayLineMemory + dlSize * v);
+            }
         }
 
-        // 7. Validate and initialize the filter.
+        // 4. Validate and initialize the filter.
         //    Keep all 4 SIMD voices active (the default) — matching library
         //    test patterns. This ensures all lanes have valid coefficients
         //    during processing, preventing NaN/Inf from division-by-zero in
         //    filters like K35. We read only lane 0 via processMonoSample().
-        bool ok = filter.prepareInstance();
+        bool ok = delayLinesOk && filter.prepareInstance();
 
         // If prepareInstance failed, fall back to SVF LP (always valid)
         if (!ok)
@@ -523,12 +1426,12 @@ private:
             filter.prepareInstance();
         }
 
-        // 8. Re-apply sample rate and block size after prepareInstance's reset().
+        // 5. Re-apply sample rate and block size after prepareInstance's reset().
         //    While reset() preserves maker sampleRates, this ensures the payload
-        //    and qfuState are in perfect sync with the current sample rate.
-        filter.setSampleRateAndBlockSize(sampleRate, kFilterBlockSize);
+        //    and qfuState are in perfect sync with the current (oversampled) rate.
+        applyFilterRate();
 
-        // 9. Prime the filter with initial coefficients for ALL 4 SIMD voices.
+        // 6. Prime the filter with initial coefficients for ALL 4 SIMD voices.
         //    Uses a safe initial cutoff (A440 = noteVal 0) and zero resonance.
         //    This ensures all SIMD lanes have valid non-zero coefficients before
         //    any audio processing begins, preventing NaN from uninitialized state.
@@ -537,9 +1440,12 @@ private:
         filter.prepareBlock();
         filter.concludeBlock();
 
-        // 10. Reset sub-block position so the CPU path starts a fresh block
+        // 7. Reset sub-block position so the CPU path starts a fresh block
         filterBlockPos = 0;
 
+        // 8. Pick the block loop: native SVF kernel or the library
+        selectFilterKernel(entry);
+
         currentFilterTypeIndex = typeIndex;
         currentFilterSubType = subType;
     }
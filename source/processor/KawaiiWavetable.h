@@ -0,0 +1,157 @@
+/**
+ * KawaiiWavetable.h — Single-cycle harmonic wavetable for collapsed voices
+ *
+ * When every partial shares the same ADSR settings, all partial envelopes
+ * move in lockstep and the voice is just a fixed harmonic spectrum times one
+ * envelope. The spectrum (the partial levels) is baked into one cycle of
+ * Σ level_k · sin(2π k φ), and the voice renders it with one interpolated
+ * table read per sample instead of NumPartials sines.
+ *
+ * Mipmapped per octave: level m holds harmonics 1 … NumPartials >> m. A note
+ * can only use a level that holds exactly its audible harmonics; a note whose
+ * audible count falls between two levels is not collapsed (levelFor returns
+ * nullptr), since the lower level would drop harmonics that per-partial
+ * synthesis plays. Tables never alias and do not depend on the sample rate.
+ *
+ * Table length is 32 samples per cycle of the highest harmonic, which keeps
+ * linear interpolation error below −55 dB on every harmonic. Baking reads the
+ * shared sine table (SharedTables; k·j mod L indexes it exactly at a fixed
+ * stride) — no libm in the bake loop — and is skipped when the levels have
+ * not changed.
+ *
+ * Double-buffered: a level change bakes into the back tables in slices of
+ * kStepBudget multiply-adds, one bakeStep() per audio block, and the tables
+ * swap once the bake is complete. Meanwhile ready() is false and voices
+ * render per partial, so a 128-partial bake (~1M multiply-adds) never lands
+ * in a single block.
+ */
+
+#pragma once
+
+#include <array>
+#include <climits>
+#include <cstdint>
+#include "KawaiiSharedTables.h"
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+template <int NumPartials>
+class HarmonicWavetable
+{
+public:
+    static constexpr int log2i(int n) { return n <= 1 ? 0 : 1 + log2i(n / 2); }
+
+    static constexpr int kNumLevels = log2i(NumPartials) + 1;
+    static constexpr int kTableSize = (NumPartials * 32 < 512) ? 512 : NumPartials * 32;
+    static constexpr int kTableBits = log2i(kTableSize);
+    static constexpr int kTableMask = kTableSize - 1;
+    static constexpr int kStride    = kTableSize + 1;   // +1 guard point for interpolation
+
+    static_assert((kTableSize & kTableMask) == 0, "table size must be a power of two");
+    static_assert(SharedTables::kSineSize % kTableSize == 0, "shared sine must cover the table");
+
+    static constexpr int kSineStride = SharedTables::kSineSize / kTableSize;
+
+    static constexpr int kStepBudget = 1 << 16;  // multiply-adds per bakeStep() on the audio thread
+    static constexpr int kWholeBake = INT_MAX;   // bakeStep() budget off the audio thread
+
+    HarmonicWavetable()
+    {
+        frontLevels.fill(-1.0);
+        tables.fill(0.0f);
+    }
+
+    // Partial levels the tables should hold. Cheap no-op when they match the
+    // front tables or the bake in progress; otherwise bakeStep() starts over.
+    void setLevels(const std::array<double, NumPartials>& levels)
+    {
+        if (baking ? levels == targetLevels : levels == frontLevels)
+            return;
+
+        baking = levels != frontLevels;   // back to the front's levels: cancel
+        targetLevels = levels;
+        bakeLevel = 0;
+        bakeRow = 0;
+    }
+
+    // Front tables hold the levels last set: voices may collapse onto them
+    bool ready() const { return !baking && hasBaked; }
+
+    // Bake table rows into the back tables until about `budget` multiply-adds
+    // are spent. True if that completed the bake and swapped the tables in.
+    // sine is SharedTables::sine().
+    bool bakeStep(const float* sine, int budget = kStepBudget)
+    {
+        if (!baking)
+            return false;
+
+        float* back = &tables[(size_t)((1 - front) * kNumLevels * kStride)];
+        int spent = 0;
+        while (bakeLevel < kNumLevels)
+        {
+            if (spent >= budget)
+                return false;
+
+            int numHarmonics = NumPartials >> bakeLevel;
+            float* table = back + bakeLevel * kStride;
+
+            double sum = 0.0;
+            for (int k = 1; k <= numHarmonics; k++)
+                sum += targetLevels[(size_t)(k - 1)] * sine[(size_t)(((k * bakeRow) & kTableMask) * kSineStride)];
+            table[bakeRow] = static_cast<float>(sum);
+            spent += numHarmonics;
+
+            if (++bakeRow == kTableSize)
+            {
+                table[kTableSize] = table[0];
+                bakeRow = 0;
+                bakeLevel++;
+            }
+        }
+
+        front = 1 - front;
+        frontLevels = targetLevels;
+        baking = false;
+        hasBaked = true;
+        return true;
+    }
+
+    // Mip level holding exactly harmonics 1 … audibleHarmonics (the voice's
+    // audible partial count, capped at NumPartials), or nullptr if no level
+    // does — including when not even the fundamental is audible.
+    const float* levelFor(int audibleHarmonics) const
+    {
+        const float* tablesFront = &tables[(size_t)(front * kNumLevels * kStride)];
+        int m = 0;
+        while (m < kNumLevels && (NumPartials >> m) > audibleHarmonics)
+            m++;
+        if (m == kNumLevels || (m > 0 && (NumPartials >> m) != audibleHarmonics))
+            return nullptr;
+        return tablesFront + m * kStride;
+    }
+
+    // Linear-interpolated read at a fixed-point phase (KawaiiPhase.h): the
+    // top kTableBits index the table, the rest are the fraction
+    static float read(const float* table, uint32_t phase)
+    {
+        uint32_t i = phase >> (32 - kTableBits);
+        float frac = static_cast<float>((phase << kTableBits) * (1.0 / 4294967296.0));
+        return table[i] + (table[i + 1] - table[i]) * frac;
+    }
+
+private:
+    std::array<float, (size_t)2 * kNumLevels * kStride> tables;   // front, back
+    int front = 0;
+    std::array<double, NumPartials> frontLevels;    // what the front tables hold
+    std::array<double, NumPartials> targetLevels;   // what the bake in progress writes
+    bool baking = false;
+    bool hasBaked = false;
+    int bakeLevel = 0;     // next row of the bake in progress …
+    int bakeRow = 0;       // … in mip level bakeLevel
+};
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
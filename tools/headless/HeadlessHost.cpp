@@ -0,0 +1,223 @@
+/**
+ * HeadlessHost.cpp — Offline host lifecycle and per-block plumbing
+ */
+
+#include "HeadlessHost.h"
+#include "public.sdk/source/common/memorystream.h"
+
+#include <algorithm>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+HeadlessHost::HeadlessHost()
+    : events(512)
+    , paramChanges(kNumParams)
+    , outputParamChanges(kNumParams)
+{
+}
+
+HeadlessHost::~HeadlessHost()
+{
+    stop();
+}
+
+bool HeadlessHost::start(const Setup& newSetup)
+{
+    stop();
+
+    proc = new KawaiiProcessor;
+    if (proc->initialize(nullptr) != kResultOk)
+    {
+        proc->release();
+        proc = nullptr;
+        return false;
+    }
+
+    setup = newSetup;
+    return activate();
+}
+
+void HeadlessHost::stop()
+{
+    if (!proc)
+        return;
+
+    deactivate();
+    proc->terminate();
+    proc->release();
+    proc = nullptr;
+}
+
+bool HeadlessHost::restart(const Setup& newSetup)
+{
+    if (!proc)
+        return start(newSetup);
+
+    deactivate();
+    setup = newSetup;
+    return activate();
+}
+
+bool HeadlessHost::activate()
+{
+    ProcessSetup ps {};
+    ps.processMode        = setup.processMode;
+    ps.symbolicSampleSize = kSample32;
+    ps.maxSamplesPerBlock = setup.maxBlockSize;
+    ps.sampleRate         = setup.sampleRate;
+
+    if (proc->setupProcessing(ps) != kResultOk)
+        return false;
+
+    inputBuffers.assign(kNumChannels, std::vector<float>((size_t)setup.maxBlockSize, 0.0f));
+    outputBuffers.assign(kNumChannels, std::vector<float>((size_t)setup.maxBlockSize, 0.0f));
+    for (int32 ch = 0; ch < kNumChannels; ch++)
+    {
+        inputPtrs[ch]  = inputBuffers[(size_t)ch].data();
+        outputPtrs[ch] = outputBuffers[(size_t)ch].data();
+    }
+
+    inputBus.numChannels       = kNumChannels;
+    inputBus.channelBuffers32  = inputPtrs;
+    outputBus.numChannels      = kNumChannels;
+    outputBus.channelBuffers32 = outputPtrs;
+
+    if (proc->setActive(true) != kResultOk)
+        return false;
+    proc->setProcessing(true);
+
+    running = true;
+    return true;
+}
+
+void HeadlessHost::deactivate()
+{
+    if (!running)
+        return;
+
+    proc->setProcessing(false);
+    proc->setActive(false);
+    running = false;
+}
+
+bool HeadlessHost::setStateParam(ParamID id, ParamValue value)
+{
+    if (!proc || id >= kNumParams)
+        return false;
+
+    // State is a flat float array in param-ID order (see KawaiiProcessor::getState)
+    MemoryStream stream;
+    if (proc->getState(&stream) != kResultOk)
+        return false;
+
+    auto* values = reinterpret_cast<float*>(stream.getData());
+    if (stream.getSize() < (int64)((id + 1) * sizeof(float)))
+        return false;
+    values[id] = static_cast<float>(value);
+
+    stream.seek(0, IBStream::kIBSeekSet, nullptr);
+    return proc->setState(&stream) == kResultOk;
+}
+
+bool HeadlessHost::setStateParams(const std::vector<ParamValue>& values)
+{
+    if (!proc)
+        return false;
+
+    MemoryStream stream;
+    for (ParamValue v : values)
+    {
+        float value = static_cast<float>(v);
+        int32 written = 0;
+        if (stream.write(&value, sizeof(float), &written) != kResultOk)
+            return false;
+    }
+
+    stream.seek(0, IBStream::kIBSeekSet, nullptr);
+    return proc->setState(&stream) == kResultOk;
+}
+
+void HeadlessHost::noteOn(int16 pitch, float velocity, int32 sampleOffset)
+{
+    Event e {};
+    e.type = Event::kNoteOnEvent;
+    e.sampleOffset = sampleOffset;
+    e.noteOn.pitch = pitch;
+    e.noteOn.velocity = velocity;
+    e.noteOn.noteId = -1;
+    events.addEvent(e);
+}
+
+void HeadlessHost::noteOff(int16 pitch, int32 sampleOffset)
+{
+    Event e {};
+    e.type = Event::kNoteOffEvent;
+    e.sampleOffset = sampleOffset;
+    e.noteOff.pitch = pitch;
+    e.noteOff.noteId = -1;
+    events.addEvent(e);
+}
+
+void HeadlessHost::event(const Event& e)
+{
+    Event copy = e;
+    events.addEvent(copy);
+}
+
+void HeadlessHost::setParam(ParamID id, ParamValue value, int32 sampleOffset)
+{
+    int32 queueIndex = 0;
+    if (auto* queue = paramChanges.addParameterData(id, queueIndex))
+    {
+        int32 pointIndex = 0;
+        queue->addPoint(sampleOffset, value, pointIndex);
+    }
+}
+
+bool HeadlessHost::outputParam(ParamID id, ParamValue& value)
+{
+    for (int32 i = 0; i < outputParamChanges.getParameterCount(); i++)
+    {
+        IParamValueQueue* queue = outputParamChanges.getParameterData(i);
+        if (!queue || queue->getParameterId() != id || queue->getPointCount() == 0)
+            continue;
+
+        int32 sampleOffset;
+        return queue->getPoint(queue->getPointCount() - 1, sampleOffset, value) == kResultOk;
+    }
+    return false;
+}
+
+tresult HeadlessHost::process(int32 numSamples)
+{
+    if (!running)
+        return kResultFalse;
+
+    numSamples = std::clamp(numSamples, (int32)0, setup.maxBlockSize);
+
+    ProcessData data;
+    data.processMode            = setup.processMode;
+    data.symbolicSampleSize     = kSample32;
+    data.numSamples             = numSamples;
+    data.numInputs              = 1;
+    data.numOutputs             = 1;
+    data.inputs                 = &inputBus;
+    data.outputs                = &outputBus;
+    data.inputParameterChanges  = &paramChanges;
+    data.inputEvents            = &events;
+    data.outputParameterChanges = &outputParamChanges;
+
+    outputParamChanges.clearQueue();
+    outputBus.silenceFlags = 0;
+    tresult result = proc->process(data);
+
+    events.clear();
+    paramChanges.clearQueue();
+    return result;
+}
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
@@ -0,0 +1,105 @@
+/**
+ * HeadlessHost.h — Minimal offline VST3 host around one KawaiiProcessor
+ *
+ * Drives the processor exactly the way a DAW does (initialize →
+ * setupProcessing → setActive → setProcessing → process…) without a UI,
+ * a plugin bundle or a host application. Used by the command-line tools in
+ * tools/ to render, stress and benchmark the engine.
+ *
+ * Events and parameter points queued between process() calls are delivered
+ * with the next block and then cleared, like a host's per-block lists. The
+ * processor's output parameter changes are kept until the next block.
+ */
+
+#pragma once
+
+#include "processor/KawaiiProcessor.h"
+#include "public.sdk/source/vst/hosting/eventlist.h"
+#include "public.sdk/source/vst/hosting/parameterchanges.h"
+
+#include <vector>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+class HeadlessHost
+{
+public:
+    struct Setup
+    {
+        double sampleRate   = 44100.0;
+        int32  maxBlockSize = 512;
+        int32  processMode  = kOffline;
+    };
+
+    static constexpr int32 kNumChannels = 2;
+
+    HeadlessHost();
+    ~HeadlessHost();
+
+    HeadlessHost(const HeadlessHost&) = delete;
+    HeadlessHost& operator=(const HeadlessHost&) = delete;
+
+    // Create, initialize and activate the processor. Returns false on failure.
+    bool start(const Setup& setup);
+
+    // Deactivate and release the processor
+    void stop();
+
+    // Deactivate, apply a new setup (e.g. a sample-rate change), re-activate.
+    // Parameter state survives the restart, as it does in a host.
+    bool restart(const Setup& setup);
+
+    // Set a parameter through the processor's state, outside process().
+    // Use for structural params read at activation (e.g. Partial Count);
+    // takes effect on the next restart().
+    bool setStateParam(ParamID id, ParamValue value);
+
+    // The whole state at once (values in param-ID order, as floats like any
+    // saved state)
+    bool setStateParams(const std::vector<ParamValue>& values);
+
+    // --- Per-block input (delivered with the next process() call) ---
+    void noteOn(int16 pitch, float velocity, int32 sampleOffset = 0);
+    void noteOff(int16 pitch, int32 sampleOffset = 0);
+    void setParam(ParamID id, ParamValue value, int32 sampleOffset = 0);
+    void event(const Event& e);
+
+    // Render one block of numSamples (≤ maxBlockSize)
+    tresult process(int32 numSamples);
+
+    const float* output(int32 channel) const { return outputBuffers[(size_t)channel].data(); }
+    uint64 outputSilenceFlags() const { return outputBus.silenceFlags; }
+
+    // Value the processor sent for an output parameter (e.g. Render Backend)
+    // during the last process() call; false if it sent none
+    bool outputParam(ParamID id, ParamValue& value);
+
+    KawaiiProcessor* processor() const { return proc; }
+    const Setup& getSetup() const { return setup; }
+    bool isRunning() const { return running; }
+
+private:
+    bool activate();
+    void deactivate();
+
+    KawaiiProcessor* proc = nullptr;
+    Setup setup;
+    bool running = false;
+
+    EventList events;
+    ParameterChanges paramChanges;
+    ParameterChanges outputParamChanges;
+
+    std::vector<std::vector<float>> inputBuffers;
+    std::vector<std::vector<float>> outputBuffers;
+    float* inputPtrs[kNumChannels] = {};
+    float* outputPtrs[kNumChannels] = {};
+    AudioBusBuffers inputBus;
+    AudioBusBuffers outputBus;
+};
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
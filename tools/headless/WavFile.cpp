@@ -0,0 +1,127 @@
+/**
+ * WavFile.cpp — Minimal RIFF/WAVE (format 3, IEEE float) writer and reader
+ */
+
+#include "WavFile.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+namespace {
+
+void put32(FILE* f, uint32_t v) { fwrite(&v, 4, 1, f); }
+void put16(FILE* f, uint16_t v) { fwrite(&v, 2, 1, f); }
+
+bool get32(FILE* f, uint32_t& v) { return fread(&v, 4, 1, f) == 1; }
+bool get16(FILE* f, uint16_t& v) { return fread(&v, 2, 1, f) == 1; }
+
+} // namespace
+
+bool writeWavFloat(const std::string& path,
+                   const std::vector<std::vector<float>>& channels,
+                   double sampleRate)
+{
+    if (channels.empty())
+        return false;
+
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f)
+        return false;
+
+    const uint16_t numChannels = static_cast<uint16_t>(channels.size());
+    const uint32_t numFrames   = static_cast<uint32_t>(channels[0].size());
+    const uint32_t rate        = static_cast<uint32_t>(sampleRate + 0.5);
+    const uint32_t dataBytes   = numFrames * numChannels * sizeof(float);
+
+    fwrite("RIFF", 1, 4, f);
+    put32(f, 36 + dataBytes);
+    fwrite("WAVE", 1, 4, f);
+
+    fwrite("fmt ", 1, 4, f);
+    put32(f, 16);
+    put16(f, 3);                                    // WAVE_FORMAT_IEEE_FLOAT
+    put16(f, numChannels);
+    put32(f, rate);
+    put32(f, rate * numChannels * sizeof(float));   // byte rate
+    put16(f, static_cast<uint16_t>(numChannels * sizeof(float)));
+    put16(f, 32);
+
+    fwrite("data", 1, 4, f);
+    put32(f, dataBytes);
+
+    // Interleave on the way out
+    for (uint32_t i = 0; i < numFrames; i++)
+        for (uint16_t ch = 0; ch < numChannels; ch++)
+            fwrite(&channels[ch][i], sizeof(float), 1, f);
+
+    bool ok = ferror(f) == 0;
+    fclose(f);
+    return ok;
+}
+
+bool readWavFloat(const std::string& path,
+                  std::vector<std::vector<float>>& channels,
+                  double& sampleRate)
+{
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f)
+        return false;
+
+    char id[4];
+    uint32_t size = 0;
+    bool ok = fread(id, 1, 4, f) == 4 && memcmp(id, "RIFF", 4) == 0
+           && get32(f, size)
+           && fread(id, 1, 4, f) == 4 && memcmp(id, "WAVE", 4) == 0;
+
+    uint16_t format = 0, numChannels = 0, bits = 0;
+    uint32_t rate = 0;
+    bool haveFormat = false;
+
+    // Walk the chunks: fmt first, then data; skip anything else
+    while (ok && fread(id, 1, 4, f) == 4 && get32(f, size))
+    {
+        if (memcmp(id, "fmt ", 4) == 0 && size >= 16)
+        {
+            uint32_t byteRate;
+            uint16_t blockAlign;
+            ok = get16(f, format) && get16(f, numChannels) && get32(f, rate)
+              && get32(f, byteRate) && get16(f, blockAlign) && get16(f, bits)
+              && fseek(f, (long)(size - 16 + (size & 1)), SEEK_CUR) == 0;
+            haveFormat = ok;
+        }
+        else if (memcmp(id, "data", 4) == 0)
+        {
+            ok = haveFormat && format == 3 && bits == 32 && numChannels > 0;
+            if (!ok)
+                break;
+
+            uint32_t numFrames = size / (numChannels * sizeof(float));
+            std::vector<float> interleaved((size_t)numFrames * numChannels);
+            ok = fread(interleaved.data(), sizeof(float), interleaved.size(), f) == interleaved.size();
+
+            channels.assign(numChannels, std::vector<float>(numFrames));
+            for (uint32_t i = 0; i < numFrames; i++)
+                for (uint16_t ch = 0; ch < numChannels; ch++)
+                    channels[ch][i] = interleaved[(size_t)i * numChannels + ch];
+            sampleRate = rate;
+            fclose(f);
+            return ok;
+        }
+        else
+        {
+            ok = fseek(f, (long)(size + (size & 1)), SEEK_CUR) == 0;
+        }
+    }
+
+    fclose(f);
+    return false;
+}
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
@@ -0,0 +1,27 @@
+/**
+ * WavFile.h — 32-bit float WAV I/O for the headless tools
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Steinberg {
+namespace Vst {
+namespace Kawaii {
+
+// Write planar channels as an IEEE-float WAV. All channels must be the same length.
+bool writeWavFloat(const std::string& path,
+                   const std::vector<std::vector<float>>& channels,
+                   double sampleRate);
+
+// Read an IEEE-float WAV (as written above) into planar channels.
+// False for anything else — other formats are not golden files.
+bool readWavFloat(const std::string& path,
+                  std::vector<std::vector<float>>& channels,
+                  double& sampleRate);
+
+} // namespace Kawaii
+} // namespace Vst
+} // namespace Steinberg
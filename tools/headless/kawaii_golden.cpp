@@ -0,0 +1,444 @@
+/**
+ * kawaii_golden — Golden-render regression check for the DSP hot paths
+ *
+ * Usage:
+ *   kawaii_golden [--dir path] [--only substring] [--update] [--list]
+ *
+ * Renders a fixed set of scenarios through KawaiiProcessor (offline, full
+ * quality) and compares each against <dir>/<scenario>.wav sample by
+ * sample. A scenario fails when any sample differs by more than its
+ * tolerance, when the lengths differ, or when the render holds a NaN/Inf.
+ * Exit status is the number of failures (capped at 125), so it can gate a
+ * build script or CI step directly.
+ *
+ * --update writes the current renders as the new goldens instead. Only do
+ * that from a build whose output has been checked by ear and by spectrum —
+ * the goldens are the definition of "correct" for every later change to
+ * the oscillator, envelope and filter code.
+ *
+ * The first set comes from the pre-optimization baseline, 95d9e2a, not from
+ * a later tree. That commit has 32 fixed partials (kNumParams 172) and no
+ * partial-count, oversampling, spectral or multi-rate params, so only
+ * filter_*, env_*, voice_steal, sr_* and block_* are recorded there (build
+ * this tool and HeadlessHost against its source/, skipping the params it
+ * lacks, and run --update --only <scenario>). The rest are recorded once
+ * checked by ear. ctest only registers the golden test once
+ * goldens exist in tools/golden.
+ *
+ * Scenarios:
+ *   filter_*        every filter type on a resonant chord with release
+ *   env_*           envelope extremes (instant, slowest, zero sustain)
+ *   voice_steal     more notes than kMaxVoices; with every voice busy, a
+ *                   note-on retakes the first voice slot
+ *   partials_*      smallest and largest partial-count variants
+ *   sr_*            96 kHz, and a 44.1 → 48 kHz restart of a live instance
+ *   block_*         odd and tiny host blocks (sub-block carry paths)
+ *   oversample_4x, spectral, multi_rate
+ *
+ * The offload path renders one block late; the render is shifted back by
+ * the reported latency, so the same goldens check both paths. Tolerances
+ * leave room for that (float sin on the GPU) and little else.
+ */
+
+#include "HeadlessHost.h"
+#include "WavFile.h"
+#include "params/KawaiiFilterTypes.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#ifndef KAWAII_GOLDEN_DIR
+#define KAWAII_GOLDEN_DIR "golden"
+#endif
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+using namespace Steinberg::Vst::Kawaii;
+
+namespace {
+
+struct NoteEvent
+{
+    double onSeconds;
+    double offSeconds;
+    int16 pitch;
+    float velocity;
+};
+
+struct ParamSetting
+{
+    ParamID id;
+    ParamValue value;
+};
+
+struct Scenario
+{
+    std::string name;
+    double sampleRate = 44100.0;
+    int32 blockSize = 512;
+    double seconds = 1.5;
+    int partials = 0;                  // 0 = default partial count
+    std::vector<NoteEvent> notes;
+    std::vector<ParamSetting> params;  // sent with the first block
+    double restartSampleRate = 0.0;    // > 0: render again after a restart at this rate
+    double tolerance = 1e-5;           // max |render − golden|
+};
+
+// Chord with a release inside the render, so attack, sustain and release
+// all land in the golden
+std::vector<NoteEvent> chord(std::initializer_list<int> pitches, double offSeconds = 1.0)
+{
+    std::vector<NoteEvent> notes;
+    for (int p : pitches)
+        notes.push_back({ 0.0, offSeconds, static_cast<int16>(p), 0.8f });
+    return notes;
+}
+
+std::string slug(const char* name)
+{
+    std::string s;
+    for (const char* c = name; *c; c++)
+        s += std::isalnum(static_cast<unsigned char>(*c)) ? static_cast<char>(std::tolower(*c)) : '_';
+    return s;
+}
+
+// The same ADSR on every partial
+std::vector<ParamSetting> allPartialEnvelopes(double a, double d, double s, double r)
+{
+    std::vector<ParamSetting> params;
+    for (int i = 0; i < kMaxPartials; i++)
+    {
+        params.push_back({ partialParam(i, kPartialOffAttack),  a });
+        params.push_back({ partialParam(i, kPartialOffDecay),   d });
+        params.push_back({ partialParam(i, kPartialOffSustain), s });
+        params.push_back({ partialParam(i, kPartialOffRelease), r });
+    }
+    return params;
+}
+
+std::vector<Scenario> buildScenarios()
+{
+    std::vector<Scenario> scenarios;
+
+    // Every filter type: moderate cutoff, strong resonance, per-note filter env
+    const auto& types = getFilterTypes();
+    for (int t = 0; t < kNumFilterTypes; t++)
+    {
+        Scenario sc;
+        char prefix[16];
+        snprintf(prefix, sizeof(prefix), "filter_%02d_", t);
+        sc.name = prefix + slug(types[(size_t)t].name);
+        sc.notes = chord({ 48, 55, 64 });
+        sc.params = {
+            { kParamFilterType,   static_cast<double>(t) / (kNumFilterTypes - 1) },
+            { kParamFilterCutoff, 0.45 },
+            { kParamFilterReso,   0.6 },
+            { kParamFilterEnvDep, 0.8 },
+        };
+        sc.tolerance = 1e-4;   // nonlinear models amplify rounding differences
+        scenarios.push_back(sc);
+    }
+
+    // Envelope extremes
+    {
+        Scenario sc;
+        sc.name = "env_instant";
+        sc.notes = chord({ 60 }, 0.5);
+        sc.params = allPartialEnvelopes(0.0, 0.0, 1.0, 0.0);
+        scenarios.push_back(sc);
+
+        sc.name = "env_slowest";
+        sc.seconds = 3.0;
+        sc.notes = chord({ 60 }, 1.5);
+        sc.params = allPartialEnvelopes(1.0, 1.0, 0.5, 1.0);
+        scenarios.push_back(sc);
+
+        sc.name = "env_zero_sustain";
+        sc.seconds = 1.5;
+        sc.notes = chord({ 60, 67 }, 1.0);
+        sc.params = allPartialEnvelopes(0.01, 0.2, 0.0, 0.3);
+        scenarios.push_back(sc);
+    }
+
+    // Voice stealing: a note every 50 ms, more than there are voices. Once
+    // all are sounding, each extra note-on restarts voice 0 (processEvent).
+    {
+        Scenario sc;
+        sc.name = "voice_steal";
+        for (int i = 0; i < kMaxVoices + 4; i++)
+            sc.notes.push_back({ 0.05 * i, 1.2, static_cast<int16>(48 + 3 * i), 0.7f });
+        scenarios.push_back(sc);
+    }
+
+    // Partial-count variants
+    for (int count : { 8, 128 })
+    {
+        Scenario sc;
+        sc.name = "partials_" + std::to_string(count);
+        sc.partials = count;
+        sc.notes = chord({ 36, 60 });
+        scenarios.push_back(sc);
+    }
+
+    // Sample rates, including a rate change on a live instance
+    {
+        Scenario sc;
+        sc.name = "sr_96000";
+        sc.sampleRate = 96000.0;
+        sc.notes = chord({ 48, 72 });
+        sc.params = { { kParamFilterCutoff, 0.6 }, { kParamFilterReso, 0.3 } };
+        scenarios.push_back(sc);
+
+        sc.name = "sr_restart_44100_48000";
+        sc.sampleRate = 44100.0;
+        sc.restartSampleRate = 48000.0;
+        sc.seconds = 1.0;
+        sc.notes = chord({ 52, 59 }, 0.6);
+        scenarios.push_back(sc);
+    }
+
+    // Host block sizes that do not line up with the 32-sample filter grid
+    for (int32 block : { 37, 1 })
+    {
+        Scenario sc;
+        sc.name = "block_" + std::to_string(block);
+        sc.blockSize = block;
+        sc.seconds = 0.75;
+        sc.notes = chord({ 57, 64 }, 0.5);
+        sc.params = { { kParamFilterType, 10.0 / (kNumFilterTypes - 1) },   // Classic LP24
+                      { kParamFilterCutoff, 0.5 }, { kParamFilterReso, 0.5 } };
+        scenarios.push_back(sc);
+    }
+
+    // Engine options
+    {
+        Scenario sc;
+        sc.name = "oversample_4x";
+        sc.notes = chord({ 48, 60 });
+        sc.params = { { kParamFilterType, 10.0 / (kNumFilterTypes - 1) },
+                      { kParamFilterCutoff, 0.7 }, { kParamFilterReso, 0.8 },
+                      { kParamFilterOversample, 1.0 } };
+        sc.tolerance = 1e-4;
+        scenarios.push_back(sc);
+
+        sc.name = "spectral";
+        sc.params = { { kParamFilterCutoff, 0.4 }, { kParamFilterReso, 0.5 },
+                      { kParamFilterSpectral, 1.0 } };
+        sc.tolerance = 1e-5;
+        scenarios.push_back(sc);
+
+        sc.name = "multi_rate";
+        sc.params = { { kParamPartialRendering, 1.0 } };
+        scenarios.push_back(sc);
+    }
+
+    return scenarios;
+}
+
+// One pass of the note script at the host's current setup, shifted back by
+// the processor's latency and appended to out
+bool renderPass(HeadlessHost& host, const Scenario& sc, bool sendParams,
+                std::vector<std::vector<float>>& out)
+{
+    const double sr = host.getSetup().sampleRate;
+    const int32 block = host.getSetup().maxBlockSize;
+    const int64 totalFrames = static_cast<int64>(sc.seconds * sr);
+    const int64 latency = host.processor()->getLatencySamples();
+
+    if (sendParams)
+        for (const auto& p : sc.params)
+            host.setParam(p.id, p.value);
+
+    for (int64 pos = 0; pos < totalFrames + latency; )
+    {
+        int32 n = static_cast<int32>(std::min<int64>(block, totalFrames + latency - pos));
+
+        for (const auto& note : sc.notes)
+        {
+            int64 on = static_cast<int64>(note.onSeconds * sr);
+            int64 off = static_cast<int64>(note.offSeconds * sr);
+            if (on >= pos && on < pos + n)
+                host.noteOn(note.pitch, note.velocity, static_cast<int32>(on - pos));
+            if (off >= pos && off < pos + n)
+                host.noteOff(note.pitch, static_cast<int32>(off - pos));
+        }
+
+        if (host.process(n) != kResultOk)
+            return false;
+
+        int64 skip = std::clamp<int64>(latency - pos, 0, n);
+        for (int32 ch = 0; ch < HeadlessHost::kNumChannels; ch++)
+            out[(size_t)ch].insert(out[(size_t)ch].end(), host.output(ch) + skip, host.output(ch) + n);
+
+        pos += n;
+    }
+    return true;
+}
+
+bool renderScenario(const Scenario& sc, std::vector<std::vector<float>>& out)
+{
+    HeadlessHost::Setup setup;
+    setup.sampleRate = sc.sampleRate;
+    setup.maxBlockSize = sc.blockSize;
+    setup.processMode = kOffline;
+
+    HeadlessHost host;
+    if (!host.start(setup))
+        return false;
+
+    // Structural params go through state + restart, like a preset load
+    if (sc.partials > 0)
+    {
+        host.setStateParam(kParamPartialCount, partialCountToNormalized(sc.partials));
+        if (!host.restart(setup))
+            return false;
+    }
+
+    out.assign(HeadlessHost::kNumChannels, {});
+    if (!renderPass(host, sc, true, out))
+        return false;
+
+    if (sc.restartSampleRate > 0.0)
+    {
+        setup.sampleRate = sc.restartSampleRate;
+        if (!host.restart(setup) || !renderPass(host, sc, false, out))
+            return false;
+    }
+
+    host.stop();
+    return true;
+}
+
+struct Comparison
+{
+    bool ok = false;
+    double maxError = 0.0;
+    int64 worstFrame = -1;
+    const char* problem = nullptr;
+};
+
+Comparison compare(const std::vector<std::vector<float>>& render,
+                   const std::vector<std::vector<float>>& golden, double tolerance)
+{
+    Comparison c;
+    if (render.size() != golden.size() || render[0].size() != golden[0].size())
+    {
+        c.problem = "length or channel count differs";
+        return c;
+    }
+
+    for (size_t ch = 0; ch < render.size(); ch++)
+    {
+        for (size_t i = 0; i < render[ch].size(); i++)
+        {
+            if (!std::isfinite(render[ch][i]))
+            {
+                c.problem = "render contains NaN/Inf";
+                c.worstFrame = static_cast<int64>(i);
+                return c;
+            }
+            double err = std::fabs(static_cast<double>(render[ch][i]) - golden[ch][i]);
+            if (err > c.maxError)
+            {
+                c.maxError = err;
+                c.worstFrame = static_cast<int64>(i);
+            }
+        }
+    }
+
+    c.ok = c.maxError <= tolerance;
+    return c;
+}
+
+void usage()
+{
+    fprintf(stderr, "usage: kawaii_golden [--dir path] [--only substring] [--update] [--list]\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string dir = KAWAII_GOLDEN_DIR;
+    std::string only;
+    bool update = false;
+    bool list = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        auto takes = [&](const char* name) { return strcmp(a, name) == 0 && v && ++i; };
+
+        if (takes("--dir"))                  dir = v;
+        else if (takes("--only"))            only = v;
+        else if (strcmp(a, "--update") == 0) update = true;
+        else if (strcmp(a, "--list") == 0)   list = true;
+        else { usage(); return 2; }
+    }
+
+    auto scenarios = buildScenarios();
+    if (list)
+    {
+        for (const auto& sc : scenarios)
+            printf("%s\n", sc.name.c_str());
+        return 0;
+    }
+
+    if (update)
+        std::filesystem::create_directories(dir);
+
+    int failures = 0, run = 0;
+    for (const auto& sc : scenarios)
+    {
+        if (!only.empty() && sc.name.find(only) == std::string::npos)
+            continue;
+        run++;
+
+        std::string path = dir + "/" + sc.name + ".wav";
+        std::vector<std::vector<float>> render;
+        if (!renderScenario(sc, render))
+        {
+            printf("FAIL %-32s render failed\n", sc.name.c_str());
+            failures++;
+            continue;
+        }
+
+        if (update)
+        {
+            bool written = writeWavFloat(path, render, sc.sampleRate);
+            printf("%s %-32s %s\n", written ? "WROTE" : "FAIL ", sc.name.c_str(), path.c_str());
+            failures += written ? 0 : 1;
+            continue;
+        }
+
+        std::vector<std::vector<float>> golden;
+        double goldenRate = 0.0;
+        if (!readWavFloat(path, golden, goldenRate))
+        {
+            printf("FAIL %-32s no golden at %s (run with --update on a reference build)\n",
+                   sc.name.c_str(), path.c_str());
+            failures++;
+            continue;
+        }
+
+        Comparison c = compare(render, golden, sc.tolerance);
+        if (c.problem)
+            printf("FAIL %-32s %s\n", sc.name.c_str(), c.problem);
+        else
+            printf("%s %-32s max error %.3g at frame %lld (tolerance %.3g)\n",
+                   c.ok ? "PASS" : "FAIL", sc.name.c_str(), c.maxError,
+                   (long long)c.worstFrame, sc.tolerance);
+        failures += c.ok ? 0 : 1;
+    }
+
+    printf("kawaii_golden: %d/%d scenarios %s\n", run - failures, run, update ? "written" : "passed");
+    return std::min(failures, 125);
+}
@@ -0,0 +1,212 @@
+/**
+ * kawaii_latency — Offload-path latency / PDC correctness harness
+ *
+ * Usage:
+ *   kawaii_latency [--block 512] [--sr 44100] [--seed 1]
+ *
+ * For each host block-size pattern (full, half, random, alternating 1/max,
+ * tiny) renders the same note script twice with the same block sequence:
+ * once on the inline CPU path (zero latency — the reference) and once on
+ * the offload path. The offload render must be the reference delayed by
+ * exactly getLatencySamples(): silent before that, then sample-for-sample
+ * equal within float tolerance, including the note after an idle gap.
+ * A dropped or misplaced sample shows up as a large error; the lag with the
+ * smallest error is printed to show where the audio actually landed.
+ *
+ * Needs an offload backend: build with KAWAII_OFFLOAD_CPU_STANDIN=ON (any
+ * platform) or run on a Metal machine. The render path is forced through
+ * KawaiiProcessor::scriptDecisions(), bypassing backend selection.
+ *
+ * Exit status is the number of failing patterns; 2 if no offload backend.
+ */
+
+#include "HeadlessHost.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+using namespace Steinberg::Vst::Kawaii;
+
+namespace {
+
+static constexpr double kSeconds = 1.5;
+static constexpr double kTolerance = 1e-4;   // GPU/stand-in sum in float, inline in double
+
+struct NoteEvent
+{
+    double seconds;
+    int16 pitch;
+    bool on;
+};
+
+// Two notes with an idle gap between them, so the FIFO's pause/resume is
+// covered too
+const NoteEvent kScript[] = {
+    { 0.05, 60, true },  { 0.05, 64, true },
+    { 0.40, 60, false }, { 0.40, 64, false },
+    { 0.90, 67, true },
+    { 1.10, 67, false },
+};
+
+enum Pattern { kFull, kHalf, kRandom, kAlternating, kTiny, kNumPatterns };
+const char* const kPatternNames[kNumPatterns] = { "full", "half", "random", "alternating", "tiny" };
+
+std::vector<int32> blockSequence(Pattern pattern, int32 maxBlock, int64 totalFrames, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<int32> blocks;
+    for (int64 pos = 0; pos < totalFrames; )
+    {
+        int32 n = maxBlock;
+        switch (pattern)
+        {
+            case kFull:        n = maxBlock; break;
+            case kHalf:        n = std::max(1, maxBlock / 2); break;
+            case kRandom:      n = std::uniform_int_distribution<int32>(1, maxBlock)(rng); break;
+            case kAlternating: n = (blocks.size() % 2) ? maxBlock : 1; break;
+            case kTiny:        n = std::uniform_int_distribution<int32>(1, 8)(rng); break;
+            default: break;
+        }
+        n = static_cast<int32>(std::min<int64>(n, totalFrames - pos));
+        blocks.push_back(n);
+        pos += n;
+    }
+    return blocks;
+}
+
+// Render the script on one path; latency receives getLatencySamples()
+bool render(const HeadlessHost::Setup& setup, bool offloadPath, const std::vector<int32>& blocks,
+            std::vector<float>& out, int& latency)
+{
+    HeadlessHost host;
+    if (!host.start(setup))
+        return false;
+    host.processor()->scriptDecisions(QualityGovernor::kTierFull, false, offloadPath);
+    if (!host.restart(setup))
+        return false;
+    latency = static_cast<int>(host.processor()->getLatencySamples());
+
+    // Short releases so the gap goes idle; partial 2 gets its own attack so
+    // the inline path does not collapse to the wavetable (same math as offload)
+    for (int i = 0; i < kMaxPartials; i++)
+        host.setParam(partialParam(i, kPartialOffRelease), 0.05);
+    host.setParam(partialParam(1, kPartialOffAttack), 0.02);
+
+    out.clear();
+    int64 pos = 0;
+    for (int32 n : blocks)
+    {
+        for (const auto& e : kScript)
+        {
+            int64 frame = static_cast<int64>(e.seconds * setup.sampleRate);
+            if (frame >= pos && frame < pos + n)
+            {
+                if (e.on)
+                    host.noteOn(e.pitch, 0.8f, static_cast<int32>(frame - pos));
+                else
+                    host.noteOff(e.pitch, static_cast<int32>(frame - pos));
+            }
+        }
+        if (host.process(n) != kResultOk)
+            return false;
+        out.insert(out.end(), host.output(0), host.output(0) + n);
+        pos += n;
+    }
+    return true;
+}
+
+// Max |offload[t + lag] − reference[t]| over the overlap, with the first
+// lag samples of the offload render counted against silence
+double errorAtLag(const std::vector<float>& reference, const std::vector<float>& offload, int lag)
+{
+    double err = 0.0;
+    for (int t = 0; t < lag && t < (int)offload.size(); t++)
+        err = std::max(err, (double)std::fabs(offload[(size_t)t]));
+    for (size_t t = 0; t + (size_t)lag < offload.size(); t++)
+        err = std::max(err, (double)std::fabs(offload[t + (size_t)lag] - reference[t]));
+    return err;
+}
+
+void usage()
+{
+    fprintf(stderr, "usage: kawaii_latency [--block n] [--sr hz] [--seed n]\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    HeadlessHost::Setup setup;
+    setup.processMode = kOffline;
+    unsigned seed = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        auto takes = [&](const char* name) { return strcmp(a, name) == 0 && v && ++i; };
+
+        if (takes("--block"))      setup.maxBlockSize = atoi(v);
+        else if (takes("--sr"))    setup.sampleRate = atof(v);
+        else if (takes("--seed"))  seed = static_cast<unsigned>(strtoul(v, nullptr, 10));
+        else { usage(); return 2; }
+    }
+    if (setup.maxBlockSize <= 0 || setup.sampleRate <= 0.0)
+    {
+        usage();
+        return 2;
+    }
+
+    const int64 totalFrames = static_cast<int64>(kSeconds * setup.sampleRate);
+    int failures = 0;
+
+    for (int p = 0; p < kNumPatterns; p++)
+    {
+        auto blocks = blockSequence(static_cast<Pattern>(p), setup.maxBlockSize, totalFrames, seed + (unsigned)p);
+
+        std::vector<float> reference, offload;
+        int inlineLatency = 0, offloadLatency = 0;
+        if (!render(setup, false, blocks, reference, inlineLatency)
+            || !render(setup, true, blocks, offload, offloadLatency))
+        {
+            fprintf(stderr, "kawaii_latency: render failed (%s)\n", kPatternNames[p]);
+            return 1;
+        }
+        if (offloadLatency == 0)
+        {
+            fprintf(stderr, "kawaii_latency: no offload backend in this build "
+                            "(configure with -DKAWAII_OFFLOAD_CPU_STANDIN=ON)\n");
+            return 2;
+        }
+
+        // Where the audio actually is: the lag with the smallest error
+        int bestLag = 0;
+        double bestErr = INFINITY;
+        for (int lag = 0; lag <= 2 * setup.maxBlockSize; lag++)
+        {
+            double err = errorAtLag(reference, offload, lag);
+            if (err < bestErr)
+            {
+                bestErr = err;
+                bestLag = lag;
+            }
+        }
+
+        double err = errorAtLag(reference, offload, offloadLatency);
+        bool ok = inlineLatency == 0 && err <= kTolerance;
+        printf("%s %-12s reported %d, measured %d, max error at reported %.3g (tolerance %.3g)\n",
+               ok ? "PASS" : "FAIL", kPatternNames[p], offloadLatency, bestLag, err, kTolerance);
+        failures += ok ? 0 : 1;
+    }
+
+    printf("kawaii_latency: %d/%d block patterns passed\n", kNumPatterns - failures, kNumPatterns);
+    return failures;
+}
@@ -0,0 +1,160 @@
+/**
+ * kawaii_memory — Per-instance memory footprint report and sweep
+ *
+ * Usage:
+ *   kawaii_memory [--partials 32] [--block 512] [--sr 44100]
+ *   kawaii_memory --sweep [--sr 44100]
+ *
+ * The first form activates one instance and prints its memory per
+ * subsystem (KawaiiProcessor::memoryReport()), the Memory Footprint value
+ * it reports to the controller, and what one voice of polyphony costs.
+ * It then plays a full bank of voices and checks that nothing grew: every
+ * buffer is sized at activation, so the footprint must not depend on how
+ * many notes sound.
+ *
+ * --sweep prints the total per instance for every partial count against a
+ * range of max block sizes — the table to plan instance density from.
+ * Voices are preallocated (kMaxVoices), so polyphony enters as the per-voice
+ * column: the share of the total that scales with the voice pool.
+ *
+ * Offload staging and backend buffers only exist when an offload backend
+ * is present (Metal, or KAWAII_OFFLOAD_CPU_STANDIN).
+ */
+
+#include "HeadlessHost.h"
+#include "params/KawaiiParams.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+using namespace Steinberg::Vst::Kawaii;
+
+namespace {
+
+const int32 kSweepBlocks[] = { 64, 256, 512, 1024, 4096, 8192 };
+
+double kilobytes(size_t bytes) { return static_cast<double>(bytes) / 1024.0; }
+
+// Bytes that scale with the voice pool, per voice
+size_t perVoiceBytes(const MemoryReport& report)
+{
+    size_t scaled = report.bytes[MemoryReport::kVoices] + report.bytes[MemoryReport::kFilterState]
+                  + report.bytes[MemoryReport::kDelayLines] + report.bytes[MemoryReport::kOffloadStaging]
+                  + report.bytes[MemoryReport::kOffloadBackend];
+    return scaled / kMaxVoices;
+}
+
+bool startInstance(HeadlessHost& host, const HeadlessHost::Setup& setup, int partials)
+{
+    if (!host.start(setup))
+        return false;
+    host.setStateParam(kParamPartialCount, partialCountToNormalized(partials));
+    return host.restart(setup);
+}
+
+int report(const HeadlessHost::Setup& setup, int partials)
+{
+    HeadlessHost host;
+    if (!startInstance(host, setup, partials))
+    {
+        fprintf(stderr, "kawaii_memory: failed to start processor\n");
+        return 1;
+    }
+
+    MemoryReport before = host.processor()->memoryReport();
+    printf("kawaii_memory: %d partials, max block %d, %.0f Hz, %d voices\n",
+           partials, setup.maxBlockSize, setup.sampleRate, kMaxVoices);
+    for (int s = 0; s < MemoryReport::kNumSubsystems; s++)
+        printf("  %-16s %10.1f KB\n", MemoryReport::name(s), kilobytes(before.bytes[(size_t)s]));
+    printf("  %-16s %10.1f KB\n", "total", kilobytes(before.total()));
+    printf("  %-16s %10.1f KB  (per sample rate, shared by all instances)\n",
+           "shared tables", kilobytes(before.sharedBytes));
+    printf("  per voice        %10.1f KB\n", kilobytes(perVoiceBytes(before)));
+
+    // What the controller sees
+    ParamValue footprint = 0.0;
+    host.process(0);
+    if (host.outputParam(kParamMemoryFootprint, footprint))
+        printf("  Memory Footprint output param: %.2f MB\n", footprint * ParamRanges::kMemoryFootprintMaxMB);
+
+    // A full bank playing must not change the footprint
+    for (int v = 0; v < kMaxVoices; v++)
+        host.noteOn(static_cast<int16>(48 + v), 0.8f);
+    for (int b = 0; b < 64; b++)
+        host.process(setup.maxBlockSize);
+    MemoryReport playing = host.processor()->memoryReport();
+    if (playing.total() != before.total())
+    {
+        printf("FAIL footprint changed while playing: %.1f KB -> %.1f KB\n",
+               kilobytes(before.total()), kilobytes(playing.total()));
+        return 1;
+    }
+    printf("  unchanged with %d voices playing\n", kMaxVoices);
+    return 0;
+}
+
+int sweep(HeadlessHost::Setup setup)
+{
+    printf("kawaii_memory: total KB per instance at %.0f Hz (per voice in brackets)\n", setup.sampleRate);
+    printf("%9s", "partials");
+    for (int32 block : kSweepBlocks)
+        printf(" %18d", block);
+    printf("\n");
+
+    for (int i = 0; i < kNumPartialCountOptions; i++)
+    {
+        int partials = kPartialCountOptions[i];
+        printf("%9d", partials);
+        for (int32 block : kSweepBlocks)
+        {
+            setup.maxBlockSize = block;
+            HeadlessHost host;
+            if (!startInstance(host, setup, partials))
+            {
+                fprintf(stderr, "\nkawaii_memory: failed to start processor\n");
+                return 1;
+            }
+            MemoryReport r = host.processor()->memoryReport();
+            printf(" %9.0f [%6.0f]", kilobytes(r.total()), kilobytes(perVoiceBytes(r)));
+        }
+        printf("\n");
+    }
+    return 0;
+}
+
+void usage()
+{
+    fprintf(stderr, "usage: kawaii_memory [--partials n] [--block n] [--sr hz] [--sweep]\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    HeadlessHost::Setup setup;
+    int partials = kPartialCountOptions[kDefaultPartialCountIndex];
+    bool doSweep = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        auto takes = [&](const char* name) { return strcmp(a, name) == 0 && v && ++i; };
+
+        if (strcmp(a, "--sweep") == 0)   doSweep = true;
+        else if (takes("--partials"))    partials = atoi(v);
+        else if (takes("--block"))       setup.maxBlockSize = atoi(v);
+        else if (takes("--sr"))          setup.sampleRate = atof(v);
+        else { usage(); return 2; }
+    }
+    if (setup.maxBlockSize <= 0 || setup.sampleRate <= 0.0)
+    {
+        usage();
+        return 2;
+    }
+
+    return doSweep ? sweep(setup) : report(setup, partials);
+}
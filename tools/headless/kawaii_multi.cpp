@@ -0,0 +1,462 @@
+/**
+ * kawaii_multi — Multi-instance host simulation benchmark
+ *
+ * Usage:
+ *   kawaii_multi [--instances 1,8,30,60] [--threads 1,2,4,8] [--seconds 10]
+ *                [--block 256] [--sr 48000] [--partials 32] [--auto-quality]
+ *
+ * Runs N KawaiiProcessor instances in one process the way a DAW runs N
+ * instrument tracks: every host period (one block) each track gets its own
+ * MIDI and is processed by one of T worker threads, which take tracks from
+ * a shared queue; the period ends when every track is done. One run per
+ * (N, T) pair from the lists.
+ *
+ * Per run it reports:
+ *   RTF         wall time / audio time over the run (< 1: keeps up)
+ *   p99, max    period load — wall time of a period / its audio duration;
+ *               above 1.0 a host would have dropped out (counted as xruns)
+ *   inst·s/s    instance-seconds of audio rendered per wall second
+ *   speedup     against the same N on the first --threads entry
+ *   us/blk      worker time per instance per block, and its ratio to the
+ *               first run. Ideal scaling keeps this flat as N and T grow;
+ *               if it climbs with T, instances are contending — shared
+ *               state, a lock, false sharing, or memory bandwidth.
+ *   ctx sw      worker context switches (voluntary/involuntary), per period
+ *   miss/blk    worker cache misses per instance-block (Linux perf events;
+ *               n/a where counters are not permitted)
+ *
+ * Instances are pinned to the Full quality tier so every run does the same
+ * work; --auto-quality leaves the governor on, as in a real session.
+ * Processing is in realtime mode.
+ */
+
+#include "HeadlessHost.h"
+#include "processor/KawaiiKernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+using namespace Steinberg::Vst::Kawaii;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// ----------------------------------------------------------------------------
+// Per-thread counters
+// ----------------------------------------------------------------------------
+
+struct ThreadCounters
+{
+    long voluntarySwitches = 0;
+    long involuntarySwitches = 0;
+    uint64_t cacheMisses = 0;
+    bool haveCacheMisses = false;
+};
+
+// Counts for the calling thread from construction to read()
+class ThreadCounterScope
+{
+public:
+    ThreadCounterScope()
+    {
+#if defined(__linux__)
+        perf_event_attr attr {};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        cacheFd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+        startUsage = usage();
+    }
+
+    ~ThreadCounterScope()
+    {
+#if defined(__linux__)
+        if (cacheFd >= 0)
+            close(cacheFd);
+#endif
+    }
+
+    ThreadCounters read() const
+    {
+        ThreadCounters c;
+        rusage now = usage();
+        c.voluntarySwitches = now.ru_nvcsw - startUsage.ru_nvcsw;
+        c.involuntarySwitches = now.ru_nivcsw - startUsage.ru_nivcsw;
+#if defined(__linux__)
+        uint64_t value = 0;
+        if (cacheFd >= 0 && ::read(cacheFd, &value, sizeof(value)) == (ssize_t)sizeof(value))
+        {
+            c.cacheMisses = value;
+            c.haveCacheMisses = true;
+        }
+#endif
+        return c;
+    }
+
+private:
+    static rusage usage()
+    {
+        rusage r {};
+#if defined(RUSAGE_THREAD)
+        getrusage(RUSAGE_THREAD, &r);
+#else
+        getrusage(RUSAGE_SELF, &r);   // process-wide where per-thread is unavailable
+#endif
+        return r;
+    }
+
+    rusage startUsage {};
+    int cacheFd = -1;
+};
+
+// ----------------------------------------------------------------------------
+// Host-style worker pool: one period = every track processed once
+// ----------------------------------------------------------------------------
+
+class PeriodDispatcher
+{
+public:
+    using Work = std::function<void(int track)>;
+
+    PeriodDispatcher(int numThreads, int numTracks, Work work)
+        : numTracks(numTracks), work(std::move(work))
+        , counters((size_t)numThreads), busy((size_t)numThreads)
+    {
+        for (int w = 0; w < numThreads; w++)
+            workers.emplace_back([this, w] { workerLoop(w); });
+    }
+
+    ~PeriodDispatcher() { stop(); }
+
+    // Blocks until every track has been processed
+    void runPeriod()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        nextTrack.store(0, std::memory_order_relaxed);
+        activeWorkers = (int)workers.size();
+        generation++;
+        startCv.notify_all();
+        doneCv.wait(lock, [this] { return activeWorkers == 0; });
+    }
+
+    // Join the workers; their counters and busy time are valid afterwards
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        startCv.notify_all();
+        for (auto& t : workers)
+            t.join();
+        workers.clear();
+    }
+
+    const std::vector<ThreadCounters>& workerCounters() const { return counters; }
+    const std::vector<double>& workerBusySeconds() const { return busy; }
+
+private:
+    void workerLoop(int index)
+    {
+        ThreadCounterScope scope;
+        double busySeconds = 0.0;
+        uint64_t seen = 0;
+
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                startCv.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping)
+                    break;
+                seen = generation;
+            }
+
+            auto start = Clock::now();
+            for (int t; (t = nextTrack.fetch_add(1, std::memory_order_relaxed)) < numTracks; )
+                work(t);
+            busySeconds += std::chrono::duration<double>(Clock::now() - start).count();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--activeWorkers == 0)
+                doneCv.notify_one();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        counters[(size_t)index] = scope.read();
+        busy[(size_t)index] = busySeconds;
+    }
+
+    const int numTracks;
+    Work work;
+
+    std::mutex mutex;
+    std::condition_variable startCv, doneCv;
+    uint64_t generation = 0;
+    int activeWorkers = 0;
+    bool stopping = false;
+    std::atomic<int> nextTrack { 0 };
+    std::vector<std::thread> workers;
+
+    std::vector<ThreadCounters> counters;
+    std::vector<double> busy;
+};
+
+// ----------------------------------------------------------------------------
+// Tracks: one instance each, with its own MIDI
+// ----------------------------------------------------------------------------
+
+struct Track
+{
+    std::unique_ptr<HeadlessHost> host;
+    std::mt19937 rng;
+    int64 position = 0;
+    int64 nextStep = 0;
+    int32 stepSamples = 0;      // this track's note rate (its own tempo/division)
+    std::vector<int16> held;
+
+    // Queue this period's notes, then process it
+    void process(int32 numSamples)
+    {
+        while (nextStep < position + numSamples)
+        {
+            auto offset = static_cast<int32>(nextStep - position);
+            for (int16 pitch : held)
+                host->noteOff(pitch, offset);
+            held.clear();
+
+            int chord = std::uniform_int_distribution<int>(1, 3)(rng);
+            for (int i = 0; i < chord; i++)
+            {
+                auto pitch = static_cast<int16>(std::uniform_int_distribution<int>(36, 84)(rng));
+                host->noteOn(pitch, std::uniform_real_distribution<float>(0.4f, 1.0f)(rng), offset);
+                held.push_back(pitch);
+            }
+            nextStep += stepSamples;
+        }
+        host->process(numSamples);
+        position += numSamples;
+    }
+};
+
+struct Options
+{
+    std::vector<int> instances { 1, 8, 30, 60 };
+    std::vector<int> threads { 1, 2, 4, 8 };
+    double seconds = 10.0;
+    int partials = kPartialCountOptions[kDefaultPartialCountIndex];
+    bool autoQuality = false;
+    HeadlessHost::Setup setup;
+};
+
+struct RunResult
+{
+    double rtf = 0.0, p99 = 0.0, maxLoad = 0.0;
+    int xruns = 0;
+    double throughput = 0.0;
+    double microsPerBlock = 0.0;
+    double switchesVoluntary = 0.0, switchesInvoluntary = 0.0;   // per period
+    double missesPerBlock = -1.0;                                // < 0: n/a
+};
+
+bool runOnce(const Options& opt, int numInstances, int numThreads, RunResult& result)
+{
+    const auto& setup = opt.setup;
+    std::vector<Track> tracks((size_t)numInstances);
+    for (int i = 0; i < numInstances; i++)
+    {
+        Track& track = tracks[(size_t)i];
+        track.host = std::make_unique<HeadlessHost>();
+        if (!track.host->start(setup))
+            return false;
+        track.host->setStateParam(kParamPartialCount, partialCountToNormalized(opt.partials));
+        if (!opt.autoQuality)
+            track.host->setStateParam(kParamQuality, 1.0 / static_cast<int>(QualityGovernor::kNumTiers));   // pinned Full
+        if (!track.host->restart(setup))
+            return false;
+
+        track.rng.seed(0x5eed + (unsigned)i);
+        track.stepSamples = static_cast<int32>(setup.sampleRate
+                          * std::uniform_real_distribution<double>(0.125, 0.5)(track.rng));
+        track.nextStep = std::uniform_int_distribution<int32>(0, track.stepSamples)(track.rng);
+    }
+
+    const int32 block = setup.maxBlockSize;
+    const double periodSeconds = block / setup.sampleRate;
+    const auto periods = static_cast<int64>(opt.seconds / periodSeconds);
+
+    PeriodDispatcher pool(numThreads, numInstances, [&](int t) { tracks[(size_t)t].process(block); });
+
+    std::vector<double> loads;
+    loads.reserve((size_t)periods);
+    auto runStart = Clock::now();
+    for (int64 p = 0; p < periods; p++)
+    {
+        auto start = Clock::now();
+        pool.runPeriod();
+        loads.push_back(std::chrono::duration<double>(Clock::now() - start).count() / periodSeconds);
+    }
+    double wall = std::chrono::duration<double>(Clock::now() - runStart).count();
+    pool.stop();
+
+    double audio = periods * periodSeconds;
+    result.rtf = wall / audio;
+    result.throughput = numInstances * audio / wall;
+    result.xruns = (int)std::count_if(loads.begin(), loads.end(), [](double l) { return l > 1.0; });
+    result.maxLoad = *std::max_element(loads.begin(), loads.end());
+    std::sort(loads.begin(), loads.end());
+    result.p99 = loads[std::min(loads.size() - 1, (size_t)(0.99 * (double)loads.size()))];
+
+    double busy = 0.0;
+    for (double b : pool.workerBusySeconds())
+        busy += b;
+    double instanceBlocks = static_cast<double>(periods) * numInstances;
+    result.microsPerBlock = busy * 1e6 / instanceBlocks;
+
+    uint64_t misses = 0;
+    bool haveMisses = true;
+    long voluntary = 0, involuntary = 0;
+    for (const auto& c : pool.workerCounters())
+    {
+        voluntary += c.voluntarySwitches;
+        involuntary += c.involuntarySwitches;
+        misses += c.cacheMisses;
+        haveMisses = haveMisses && c.haveCacheMisses;
+    }
+    result.switchesVoluntary = voluntary / (double)periods;
+    result.switchesInvoluntary = involuntary / (double)periods;
+    result.missesPerBlock = haveMisses ? misses / instanceBlocks : -1.0;
+
+    for (auto& track : tracks)
+        track.host->stop();
+    return true;
+}
+
+bool parseList(const char* text, std::vector<int>& out)
+{
+    out.clear();
+    std::string s(text);
+    size_t pos = 0;
+    while (pos <= s.size())
+    {
+        size_t comma = s.find(',', pos);
+        int value = atoi(s.substr(pos, comma - pos).c_str());
+        if (value <= 0)
+            return false;
+        out.push_back(value);
+        if (comma == std::string::npos)
+            break;
+        pos = comma + 1;
+    }
+    return !out.empty();
+}
+
+void usage()
+{
+    fprintf(stderr, "usage: kawaii_multi [--instances n,n,...] [--threads n,n,...] [--seconds s]\n"
+                    "                    [--block n] [--sr hz] [--partials n] [--auto-quality]\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    opt.setup.sampleRate = 48000.0;
+    opt.setup.maxBlockSize = 256;
+    opt.setup.processMode = kRealtime;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        auto takes = [&](const char* name) { return strcmp(a, name) == 0 && v && ++i; };
+
+        bool ok = true;
+        if (strcmp(a, "--auto-quality") == 0)  opt.autoQuality = true;
+        else if (takes("--instances"))         ok = parseList(v, opt.instances);
+        else if (takes("--threads"))           ok = parseList(v, opt.threads);
+        else if (takes("--seconds"))           opt.seconds = atof(v);
+        else if (takes("--block"))             opt.setup.maxBlockSize = atoi(v);
+        else if (takes("--sr"))                opt.setup.sampleRate = atof(v);
+        else if (takes("--partials"))          opt.partials = atoi(v);
+        else ok = false;
+        if (!ok)
+        {
+            usage();
+            return 2;
+        }
+    }
+    if (opt.seconds <= 0.0 || opt.setup.maxBlockSize <= 0 || opt.setup.sampleRate <= 0.0)
+    {
+        usage();
+        return 2;
+    }
+
+    printf("kawaii_multi: %d partials, block %d at %.0f Hz, %.1f s per run, quality %s, "
+           "%s kernels, %u hardware threads\n",
+           opt.partials, opt.setup.maxBlockSize, opt.setup.sampleRate, opt.seconds,
+           opt.autoQuality ? "auto" : "pinned Full", activeKernels().isa,
+           std::thread::hardware_concurrency());
+    printf("%5s %4s %7s %7s %7s %6s %9s %8s %9s %7s %13s %10s\n",
+           "inst", "thr", "RTF", "p99", "max", "xruns", "inst*s/s", "speedup",
+           "us/blk", "vs 1st", "ctx sw/period", "miss/blk");
+
+    double baseMicros = 0.0;
+    for (int n : opt.instances)
+    {
+        double firstRtf = 0.0;
+        for (int t : opt.threads)
+        {
+            RunResult r;
+            if (!runOnce(opt, n, t, r))
+            {
+                fprintf(stderr, "kawaii_multi: failed to start %d instances\n", n);
+                return 1;
+            }
+            if (baseMicros == 0.0)
+                baseMicros = r.microsPerBlock;
+            if (firstRtf == 0.0)
+                firstRtf = r.rtf;
+
+            char misses[32];
+            if (r.missesPerBlock >= 0.0)
+                snprintf(misses, sizeof(misses), "%.0f", r.missesPerBlock);
+            else
+                snprintf(misses, sizeof(misses), "n/a");
+
+            printf("%5d %4d %7.3f %7.3f %7.3f %6d %9.1f %8.2f %9.1f %7.2f %6.1f/%-6.1f %10s\n",
+                   n, t, r.rtf, r.p99, r.maxLoad, r.xruns, r.throughput,
+                   firstRtf / r.rtf, r.microsPerBlock,
+                   r.microsPerBlock / baseMicros, r.switchesVoluntary, r.switchesInvoluntary, misses);
+            fflush(stdout);
+        }
+    }
+    return 0;
+}
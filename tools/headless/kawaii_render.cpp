@@ -0,0 +1,294 @@
+/**
+ * kawaii_render — Render a note sequence through KawaiiProcessor to a WAV file
+ *
+ * Usage:
+ *   kawaii_render [--out render.wav] [--sr 44100] [--block 512] [--seconds 4]
+ *                 [--notes 60,64,67] [--velocity 0.8] [--filter-type 0-32]
+ *                 [--cutoff 0-1] [--reso 0-1] [--partials 8|16|32|64|128]
+ *                 [--oversample 1|2|4] [--multi-rate] [--realtime]
+ *                 [--bend -1..1] [--bend-range st] [--tune cents] [--scl file.scl]
+ *                 [--mod source:dest:amount]... [--lfo1 hz[:shape]] [--lfo2 hz[:shape]]
+ *                 [--wheel 0-1]
+ *
+ * Notes start at t=0 and are released at 60% of the render length.
+ * --bend glides the pitch bend from centre to the given position over that
+ * span, one parameter point per block (as a host sends MIDI bend).
+ * --scl retunes the keyboard to a Scala scale (middle C = degree 0,
+ * A4 = 440 Hz) before the notes start.
+ * --mod fills the next mod matrix slot (up to 4): source off|lfo1|lfo2|
+ * velocity|note|wheel, destination cutoff|reso|level|pitch, amount −1…1.
+ * LFO shapes are 0 sine, 1 triangle, 2 saw, 3 square.
+ * --realtime sets ProcessSetup::processMode to kRealtime (default kOffline).
+ *
+ * In a KAWAII_RT_SANITIZER build this is the intended way to exercise the
+ * audio path: every block runs inside process()'s realtime scope and the
+ * sanitizer report is written when the tool exits.
+ */
+
+#include "HeadlessHost.h"
+#include "WavFile.h"
+#include "params/KawaiiFilterTypes.h"
+#include "params/KawaiiModMatrix.h"
+#include "params/KawaiiParams.h"
+#include "params/KawaiiTuning.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+using namespace Steinberg::Vst::Kawaii;
+
+namespace {
+
+std::vector<int> parseNotes(const char* list)
+{
+    std::vector<int> notes;
+    const char* p = list;
+    while (*p)
+    {
+        char* end = nullptr;
+        long n = strtol(p, &end, 10);
+        if (end == p)
+            break;
+        notes.push_back(static_cast<int>(n));
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return notes;
+}
+
+// "lfo1:pitch:0.05" → one mod slot; false if any part is unknown
+bool parseModSlot(const char* text, int& source, int& destination, double& amount)
+{
+    static const char* const kSources[kNumModSources] = { "off", "lfo1", "lfo2", "velocity", "note", "wheel" };
+    static const char* const kDestinations[kNumModDestinations] = { "cutoff", "reso", "level", "pitch" };
+
+    std::stringstream in(text);
+    std::string sourceName, destName, amountText;
+    if (!std::getline(in, sourceName, ':') || !std::getline(in, destName, ':') || !std::getline(in, amountText))
+        return false;
+
+    source = destination = -1;
+    for (int i = 0; i < kNumModSources; i++)
+        if (sourceName == kSources[i])
+            source = i;
+    for (int i = 0; i < kNumModDestinations; i++)
+        if (destName == kDestinations[i])
+            destination = i;
+    amount = std::clamp(atof(amountText.c_str()), -1.0, 1.0);
+    return source >= 0 && destination >= 0;
+}
+
+void usage()
+{
+    fprintf(stderr,
+        "usage: kawaii_render [--out file.wav] [--sr hz] [--block n] [--seconds s]\n"
+        "                     [--notes 60,64,67] [--velocity v] [--filter-type 0-%d]\n"
+        "                     [--cutoff 0-1] [--reso 0-1] [--partials n]\n"
+        "                     [--oversample 1|2|4] [--multi-rate] [--realtime]\n"
+        "                     [--bend -1..1] [--bend-range st] [--tune cents] [--scl file.scl]\n"
+        "                     [--mod source:dest:amount]... [--lfo1 hz[:shape]] [--lfo2 hz[:shape]]\n"
+        "                     [--wheel 0-1]\n",
+        kNumFilterTypes - 1);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string outPath = "render.wav";
+    HeadlessHost::Setup setup;
+    double seconds = 4.0;
+    std::vector<int> notes = { 60, 64, 67 };
+    float velocity = 0.8f;
+    int filterType = -1;
+    double cutoff = -1.0, reso = -1.0;
+    int partials = 0;
+    int oversample = 0;
+    bool multiRate = false;
+    double bend = 0.0;
+    double bendRange = -1.0;
+    double tuneCents = 0.0;
+    const char* sclPath = nullptr;
+    int numModSlots = 0;
+    int modSource[kNumModSlots], modDest[kNumModSlots];
+    double modAmount[kNumModSlots];
+    const char* lfoSpec[2] = { nullptr, nullptr };
+    double wheel = -1.0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        auto takes = [&](const char* name) { return strcmp(a, name) == 0 && v && ++i; };
+
+        if (takes("--out"))                 outPath = v;
+        else if (takes("--sr"))             setup.sampleRate = atof(v);
+        else if (takes("--block"))          setup.maxBlockSize = atoi(v);
+        else if (takes("--seconds"))        seconds = atof(v);
+        else if (takes("--notes"))          notes = parseNotes(v);
+        else if (takes("--velocity"))       velocity = static_cast<float>(atof(v));
+        else if (takes("--filter-type"))    filterType = atoi(v);
+        else if (takes("--cutoff"))         cutoff = atof(v);
+        else if (takes("--reso"))           reso = atof(v);
+        else if (takes("--partials"))       partials = atoi(v);
+        else if (takes("--oversample"))     oversample = atoi(v);
+        else if (takes("--bend"))           bend = std::clamp(atof(v), -1.0, 1.0);
+        else if (takes("--bend-range"))     bendRange = atof(v);
+        else if (takes("--tune"))           tuneCents = atof(v);
+        else if (takes("--scl"))            sclPath = v;
+        else if (takes("--lfo1"))           lfoSpec[0] = v;
+        else if (takes("--lfo2"))           lfoSpec[1] = v;
+        else if (takes("--wheel"))          wheel = std::clamp(atof(v), 0.0, 1.0);
+        else if (takes("--mod"))
+        {
+            if (numModSlots == kNumModSlots
+                || !parseModSlot(v, modSource[numModSlots], modDest[numModSlots], modAmount[numModSlots]))
+            {
+                usage();
+                return 2;
+            }
+            numModSlots++;
+        }
+        else if (strcmp(a, "--multi-rate") == 0) multiRate = true;
+        else if (strcmp(a, "--realtime") == 0) setup.processMode = kRealtime;
+        else { usage(); return 2; }
+    }
+
+    if (setup.sampleRate <= 0.0 || setup.maxBlockSize <= 0 || seconds <= 0.0)
+    {
+        usage();
+        return 2;
+    }
+
+    HeadlessHost host;
+    if (!host.start(setup))
+    {
+        fprintf(stderr, "kawaii_render: failed to start processor\n");
+        return 1;
+    }
+
+    // Structural params go through state + restart, like a preset load
+    if (partials > 0)
+    {
+        host.setStateParam(kParamPartialCount, partialCountToNormalized(partials));
+        host.restart(setup);
+    }
+
+    if (filterType >= 0)
+        host.setParam(kParamFilterType, static_cast<double>(filterType) / (kNumFilterTypes - 1));
+    if (cutoff >= 0.0)
+        host.setParam(kParamFilterCutoff, cutoff);
+    if (reso >= 0.0)
+        host.setParam(kParamFilterReso, reso);
+    if (oversample > 0)
+        host.setParam(kParamFilterOversample, oversample >= 4 ? 1.0 : (oversample >= 2 ? 0.5 : 0.0));
+    if (multiRate)
+        host.setParam(kParamPartialRendering, 1.0);
+
+    using namespace ParamRanges;
+    if (bendRange >= 0.0)
+        host.setParam(kParamPitchBendRange, std::clamp(bendRange / kPitchBendRangeMax, 0.0, 1.0));
+    if (tuneCents != 0.0)
+        host.setParam(kParamMasterTune, std::clamp(0.5 + tuneCents / (2.0 * kMasterTuneCents), 0.0, 1.0));
+
+    static constexpr ParamID kLfoRate[]  = { kParamLfo1Rate, kParamLfo2Rate };
+    static constexpr ParamID kLfoShape[] = { kParamLfo1Shape, kParamLfo2Shape };
+    for (int l = 0; l < 2; l++)
+    {
+        if (!lfoSpec[l])
+            continue;
+        double hz = std::clamp(atof(lfoSpec[l]), kLfoRateMinHz, kLfoRateMaxHz);
+        host.setParam(kLfoRate[l], hzToNormalized(hz, kLfoRateMinHz, kLfoRateMaxHz));
+        if (const char* shape = strchr(lfoSpec[l], ':'))
+            host.setParam(kLfoShape[l], std::clamp(atoi(shape + 1), 0, kNumLfoShapes - 1)
+                                            / static_cast<double>(kNumLfoShapes - 1));
+    }
+    for (int slot = 0; slot < numModSlots; slot++)
+    {
+        host.setParam(modSlotParam(slot, kModSlotOffSource),
+                      modSource[slot] / static_cast<double>(kNumModSources - 1));
+        host.setParam(modSlotParam(slot, kModSlotOffDest),
+                      modDest[slot] / static_cast<double>(kNumModDestinations - 1));
+        host.setParam(modSlotParam(slot, kModSlotOffAmount), 0.5 + 0.5 * modAmount[slot]);
+    }
+    if (wheel >= 0.0)
+        host.setParam(kParamModWheel, wheel);
+
+    if (sclPath)
+    {
+        std::ifstream file(sclPath);
+        std::stringstream text;
+        text << file.rdbuf();
+
+        ScalaScale scale;
+        std::string error;
+        if (!file || !parseScala(text.str(), scale, &error))
+        {
+            fprintf(stderr, "kawaii_render: %s: %s\n", sclPath, file ? error.c_str() : "cannot read");
+            return 1;
+        }
+        auto pitches = scalaNotePitches(scale);
+        for (int n = 0; n < kNumMidiNotes; n++)
+            host.setParam(tuningParam(n), tuningPitchToNormalized(pitches[(size_t)n]));
+        printf("kawaii_render: tuning \"%s\" (%zu degrees)\n", scale.description.c_str(), scale.cents.size());
+    }
+
+    for (int n : notes)
+        host.noteOn(static_cast<int16>(n), velocity);
+
+    const int64 totalFrames   = static_cast<int64>(seconds * setup.sampleRate);
+    const int64 releaseFrame  = static_cast<int64>(totalFrames * 0.6);
+    bool released = false;
+
+    std::vector<std::vector<float>> rendered(HeadlessHost::kNumChannels);
+    for (auto& ch : rendered)
+        ch.reserve((size_t)totalFrames);
+
+    for (int64 pos = 0; pos < totalFrames; )
+    {
+        int32 n = static_cast<int32>(std::min<int64>(setup.maxBlockSize, totalFrames - pos));
+
+        if (bend != 0.0)
+        {
+            double t = std::min(1.0, static_cast<double>(pos) / static_cast<double>(releaseFrame));
+            host.setParam(kParamPitchBend, 0.5 + 0.5 * bend * t);
+        }
+
+        if (!released && pos + n > releaseFrame)
+        {
+            for (int note : notes)
+                host.noteOff(static_cast<int16>(note), static_cast<int32>(releaseFrame - pos));
+            released = true;
+        }
+
+        if (host.process(n) != kResultOk)
+        {
+            fprintf(stderr, "kawaii_render: process() failed at frame %lld\n", (long long)pos);
+            return 1;
+        }
+
+        for (int32 ch = 0; ch < HeadlessHost::kNumChannels; ch++)
+            rendered[(size_t)ch].insert(rendered[(size_t)ch].end(), host.output(ch), host.output(ch) + n);
+
+        pos += n;
+    }
+
+    host.stop();
+
+    if (!writeWavFloat(outPath, rendered, setup.sampleRate))
+    {
+        fprintf(stderr, "kawaii_render: could not write %s\n", outPath.c_str());
+        return 1;
+    }
+
+    printf("kawaii_render: wrote %s (%lld frames @ %.0f Hz)\n",
+           outPath.c_str(), (long long)totalFrames, setup.sampleRate);
+    return 0;
+}
@@ -0,0 +1,302 @@
+/**
+ * kawaii_replay — Play a recorded process() trace through KawaiiProcessor
+ *
+ * Usage:
+ *   kawaii_replay trace.ktrace [--out replay.wav]
+ *
+ * Traces come from a KAWAII_TRACE_RECORDER build run with $KAWAII_TRACE_DIR
+ * set (see source/diagnostics/TraceRecorder.h). Every activation is
+ * repeated with its sample rate, max block size, process mode and exact
+ * params; every block with its size, events and parameter queue points.
+ * The governor's tier changes and the render path are scripted from the
+ * trace rather than re-measured, so the replay renders what the recorded
+ * instance rendered — on the same render path. (A trace recorded on the
+ * Metal path replays exactly only on a Metal build.) A state the host
+ * loaded while the instance was active is loaded again before the block
+ * that followed it.
+ *
+ * Run it under a profiler or debugger to chase a production glitch. It
+ * prints per-block timing, and --out writes the rendered audio (at the
+ * first activation's sample rate).
+ *
+ * A trace with dropped blocks (the recorder's buffer was full) still
+ * replays, but stops being exact at the first gap; it is reported.
+ */
+
+#include "HeadlessHost.h"
+#include "WavFile.h"
+#include "diagnostics/TraceFormat.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+using namespace Steinberg::Vst::Kawaii;
+
+namespace {
+
+struct Reader
+{
+    std::vector<uint8_t> bytes;
+    size_t pos = 0;
+
+    template <typename T>
+    bool read(T& out)
+    {
+        if (bytes.size() - pos < sizeof(T))
+            return false;
+        memcpy(&out, bytes.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    bool atEnd() const { return pos >= bytes.size(); }
+};
+
+bool loadFile(const char* path, std::vector<uint8_t>& bytes)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f)
+        return false;
+    uint8_t buffer[65536];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0)
+        bytes.insert(bytes.end(), buffer, buffer + n);
+    fclose(f);
+    return true;
+}
+
+Event toEvent(const Trace::EventRecord& r)
+{
+    Event e {};
+    e.type = r.type;
+    e.sampleOffset = r.sampleOffset;
+    if (r.type == Event::kNoteOnEvent)
+    {
+        e.noteOn.channel  = r.channel;
+        e.noteOn.pitch    = r.pitch;
+        e.noteOn.tuning   = r.tuning;
+        e.noteOn.velocity = r.velocity;
+        e.noteOn.length   = r.length;
+        e.noteOn.noteId   = r.noteId;
+    }
+    else if (r.type == Event::kNoteOffEvent)
+    {
+        e.noteOff.channel  = r.channel;
+        e.noteOff.pitch    = r.pitch;
+        e.noteOff.tuning   = r.tuning;
+        e.noteOff.velocity = r.velocity;
+        e.noteOff.noteId   = r.noteId;
+    }
+    return e;
+}
+
+void usage()
+{
+    fprintf(stderr, "usage: kawaii_replay trace.ktrace [--out replay.wav]\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const char* tracePath = nullptr;
+    std::string outPath;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* a = argv[i];
+        if (strcmp(a, "--out") == 0 && i + 1 < argc)
+            outPath = argv[++i];
+        else if (!tracePath && a[0] != '-')
+            tracePath = a;
+        else { usage(); return 2; }
+    }
+    if (!tracePath)
+    {
+        usage();
+        return 2;
+    }
+
+    Reader in;
+    Trace::FileHeader header {};
+    if (!loadFile(tracePath, in.bytes) || !in.read(header)
+        || memcmp(header.magic, Trace::kMagic, sizeof(header.magic)) != 0)
+    {
+        fprintf(stderr, "kawaii_replay: %s is not a trace\n", tracePath);
+        return 1;
+    }
+    // Version 1 traces are version 2 without state records
+    if (header.version < 1 || header.version > Trace::kVersion || header.numParams != (uint32_t)kNumParams)
+    {
+        fprintf(stderr, "kawaii_replay: trace version %u with %u params; this build reads up to version %u with %d\n",
+                header.version, header.numParams, Trace::kVersion, kNumParams);
+        return 1;
+    }
+
+    HeadlessHost host;
+    HeadlessHost::Setup setup;
+    std::vector<ParamValue> params((size_t)kNumParams);
+    std::vector<std::vector<float>> rendered(HeadlessHost::kNumChannels);
+    double outputRate = 0.0;
+
+    int64 blocks = 0, activations = 0, states = 0, firstGap = -1;
+    double audioSeconds = 0.0, processSeconds = 0.0, worstMicros = 0.0, worstLoad = 0.0;
+    bool modeWarned = false;
+
+    while (!in.atEnd())
+    {
+        uint8_t type = 0;
+        if (!in.read(type))
+            break;
+
+        if (type == Trace::kRecordActivate)
+        {
+            Trace::ActivateRecord rec {};
+            if (!in.read(rec))
+                break;
+            for (auto& value : params)
+                if (!in.read(value))
+                    break;
+
+            setup.sampleRate = rec.sampleRate;
+            setup.maxBlockSize = rec.maxSamplesPerBlock;
+            setup.processMode = rec.processMode;
+            if (outputRate == 0.0)
+                outputRate = rec.sampleRate;
+
+            // State first (structural params are read at activation), then
+            // the exact values as one zero-length block: state is stored as
+            // floats, the recorded params are the processor's doubles
+            if (!host.isRunning() && !host.start(setup))
+            {
+                fprintf(stderr, "kawaii_replay: failed to start processor\n");
+                return 1;
+            }
+            host.setStateParams(params);
+            host.processor()->scriptDecisions(QualityGovernor::kTierFull, false, rec.offload != 0);
+            if (!host.restart(setup))
+            {
+                fprintf(stderr, "kawaii_replay: activation at %.0f Hz failed\n", setup.sampleRate);
+                return 1;
+            }
+            for (int32 id = 0; id < kNumParams; id++)
+                host.setParam((ParamID)id, params[(size_t)id]);
+            host.process(0);
+
+            activations++;
+        }
+        else if (type == Trace::kRecordBlock)
+        {
+            Trace::BlockHeader bh {};
+            if (!in.read(bh))
+                break;
+            if (bh.droppedBefore > 0 && firstGap < 0)
+                firstGap = blocks;
+
+            for (uint16_t i = 0; i < bh.numEvents; i++)
+            {
+                Trace::EventRecord r {};
+                if (!in.read(r))
+                    break;
+                host.event(toEvent(r));
+            }
+            for (uint16_t q = 0; q < bh.numQueues; q++)
+            {
+                Trace::QueueHeader qh {};
+                if (!in.read(qh))
+                    break;
+                for (uint16_t p = 0; p < qh.numPoints; p++)
+                {
+                    Trace::PointRecord pr {};
+                    if (!in.read(pr))
+                        break;
+                    host.setParam(qh.paramId, pr.value, pr.sampleOffset);
+                }
+            }
+
+            if (bh.processMode != setup.processMode && !modeWarned)
+            {
+                fprintf(stderr, "kawaii_replay: block process mode %d differs from setup (%d); using setup\n",
+                        bh.processMode, setup.processMode);
+                modeWarned = true;
+            }
+
+            host.processor()->scriptDecisions(bh.decisions.tier, bh.decisions.overBudget != 0,
+                                              bh.decisions.offload != 0);
+
+            auto start = std::chrono::steady_clock::now();
+            if (host.process(bh.numSamples) != kResultOk)
+            {
+                fprintf(stderr, "kawaii_replay: process() failed at block %lld\n", (long long)blocks);
+                return 1;
+            }
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            double blockSeconds = bh.numSamples / setup.sampleRate;
+            processSeconds += elapsed;
+            audioSeconds += blockSeconds;
+            worstMicros = std::max(worstMicros, elapsed * 1e6);
+            if (blockSeconds > 0.0)
+                worstLoad = std::max(worstLoad, elapsed / blockSeconds);
+
+            if (!outPath.empty())
+                for (int32 ch = 0; ch < HeadlessHost::kNumChannels; ch++)
+                    rendered[(size_t)ch].insert(rendered[(size_t)ch].end(),
+                                                host.output(ch), host.output(ch) + bh.numSamples);
+            blocks++;
+        }
+        else if (type == Trace::kRecordState)
+        {
+            for (auto& value : params)
+                if (!in.read(value))
+                    break;
+
+            // The recorded params are what setState() left, read back from
+            // floats — so loading them as a state reproduces them exactly
+            if (!host.setStateParams(params))
+            {
+                fprintf(stderr, "kawaii_replay: state load before block %lld failed\n", (long long)blocks);
+                return 1;
+            }
+            states++;
+        }
+        else if (type == Trace::kRecordDeactivate)
+        {
+            // The next activation record restarts the processor
+        }
+        else
+        {
+            fprintf(stderr, "kawaii_replay: unknown record type %u at byte %zu\n", type, in.pos - 1);
+            return 1;
+        }
+    }
+
+    host.stop();
+
+    if (!in.atEnd())
+        fprintf(stderr, "kawaii_replay: trace ends mid-record (recorder still running?)\n");
+
+    printf("kawaii_replay: %lld blocks, %lld activations, %lld state loads, %.2f s of audio\n",
+           (long long)blocks, (long long)activations, (long long)states, audioSeconds);
+    printf("  process() total %.3f s, worst block %.1f us, worst load %.3f\n",
+           processSeconds, worstMicros, worstLoad);
+    if (firstGap >= 0)
+        printf("  trace has dropped blocks: replay is exact only up to block %lld\n", (long long)firstGap);
+
+    if (!outPath.empty())
+    {
+        if (!writeWavFloat(outPath, rendered, outputRate > 0.0 ? outputRate : 44100.0))
+        {
+            fprintf(stderr, "kawaii_replay: could not write %s\n", outPath.c_str());
+            return 1;
+        }
+        printf("  wrote %s\n", outPath.c_str());
+    }
+    return 0;
+}
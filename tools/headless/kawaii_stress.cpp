@@ -0,0 +1,256 @@
+/**
+ * kawaii_stress — Randomized worst-case block-time harness
+ *
+ * Usage:
+ *   kawaii_stress [--seconds 60] [--seed 1] [--max-load 1.0] [--offline]
+ *
+ * Drives KawaiiProcessor::process() with everything a host can throw at it
+ * at once, from a seeded generator (same seed, same run):
+ *
+ *   - block sizes from 1 to 8192, log-uniform (maxSamplesPerBlock = 8192)
+ *   - bursts of note-ons past kMaxVoices, random note-offs
+ *   - parameter storms: several points per queue on filter type, subtype,
+ *     cutoff, resonance, oversampling, mode, quality and partial levels
+ *   - re-activations at a new sample rate and partial count
+ *
+ * and reports process() time per block as p50/p99/p99.9/max, both in µs
+ * and as load (time / the block's duration of audio; 1.0 = the deadline).
+ * Re-activation itself is not timed — setActive() is allowed to be slow.
+ *
+ * Fails (exit 1) if any output sample is NaN/Inf, or if the worst block's
+ * load exceeds --max-load. Runs in realtime mode by default, so the quality
+ * governor reacts as it would in a host; --offline disables it.
+ */
+
+#include "HeadlessHost.h"
+#include "params/KawaiiFilterTypes.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+using namespace Steinberg::Vst::Kawaii;
+
+namespace {
+
+static constexpr int32 kMaxStressBlock = 8192;
+static constexpr double kSampleRates[] = { 44100.0, 48000.0, 88200.0, 96000.0 };
+
+// Per-block probabilities
+static constexpr double kBurstChance   = 0.05;
+static constexpr double kNoteOffChance = 0.10;
+static constexpr double kStormChance   = 0.10;
+static constexpr double kRestartChance = 0.002;
+
+struct BlockSample
+{
+    double micros;
+    double load;
+    int32 numSamples;
+};
+
+double percentile(std::vector<double> values, double p)
+{
+    if (values.empty())
+        return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t idx = static_cast<size_t>(std::ceil(p * (double)values.size())) - 1;
+    return values[std::min(idx, values.size() - 1)];
+}
+
+// Several points across the block for a handful of params, biased towards
+// the ones that rebuild filter state
+void parameterStorm(HeadlessHost& host, std::mt19937& rng, int32 numSamples)
+{
+    static constexpr ParamID kStormParams[] = {
+        kParamFilterType, kParamFilterSubType, kParamFilterType, kParamFilterCutoff,
+        kParamFilterReso, kParamFilterEnvDep, kParamFilterKeytrk, kParamFilterOversample,
+        kParamFilterSpectral, kParamPartialRendering, kParamQuality, kParamMasterVolume,
+    };
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<int> pickParam(0, (int)(sizeof(kStormParams) / sizeof(kStormParams[0])) - 1);
+    std::uniform_int_distribution<int> pickPartial(0, kMaxPartials - 1);
+    std::uniform_int_distribution<int> pickCount(1, 8);
+    std::uniform_int_distribution<int32> pickOffset(0, std::max(0, numSamples - 1));
+
+    int count = pickCount(rng);
+    for (int i = 0; i < count; i++)
+    {
+        ParamID id = (unit(rng) < 0.25) ? partialParam(pickPartial(rng), kPartialOffLevel)
+                                        : kStormParams[pickParam(rng)];
+        int points = pickCount(rng) / 2 + 1;
+        for (int p = 0; p < points; p++)
+            host.setParam(id, unit(rng), pickOffset(rng));
+    }
+}
+
+void usage()
+{
+    fprintf(stderr, "usage: kawaii_stress [--seconds s] [--seed n] [--max-load x] [--offline]\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    double seconds = 60.0;
+    unsigned seed = 1;
+    double maxLoad = 1.0;
+    HeadlessHost::Setup setup;
+    setup.maxBlockSize = kMaxStressBlock;
+    setup.processMode = kRealtime;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        auto takes = [&](const char* name) { return strcmp(a, name) == 0 && v && ++i; };
+
+        if (takes("--seconds"))               seconds = atof(v);
+        else if (takes("--seed"))             seed = static_cast<unsigned>(strtoul(v, nullptr, 10));
+        else if (takes("--max-load"))         maxLoad = atof(v);
+        else if (strcmp(a, "--offline") == 0) setup.processMode = kOffline;
+        else { usage(); return 2; }
+    }
+
+    if (seconds <= 0.0 || maxLoad <= 0.0)
+    {
+        usage();
+        return 2;
+    }
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<int> pickPitch(24, 108);
+    std::uniform_int_distribution<int> pickBurst(1, kMaxVoices * 2);
+    std::uniform_int_distribution<int> pickRate(0, (int)(sizeof(kSampleRates) / sizeof(kSampleRates[0])) - 1);
+    std::uniform_int_distribution<int> pickPartialCount(0, kNumPartialCountOptions - 1);
+    const double logMaxBlock = std::log((double)kMaxStressBlock);
+
+    HeadlessHost host;
+    if (!host.start(setup))
+    {
+        fprintf(stderr, "kawaii_stress: failed to start processor\n");
+        return 1;
+    }
+
+    std::vector<BlockSample> blocks;
+    std::vector<int16> held;
+    double audioSeconds = 0.0;
+    int restarts = 0;
+    int64 nonFiniteSamples = 0;
+    int64 firstNonFiniteBlock = -1;
+
+    while (audioSeconds < seconds)
+    {
+        // Re-activation: new sample rate, sometimes a new partial count
+        if (unit(rng) < kRestartChance)
+        {
+            setup.sampleRate = kSampleRates[pickRate(rng)];
+            if (unit(rng) < 0.5)
+                host.setStateParam(kParamPartialCount,
+                                   static_cast<double>(pickPartialCount(rng)) / (kNumPartialCountOptions - 1));
+            if (!host.restart(setup))
+            {
+                fprintf(stderr, "kawaii_stress: restart at %.0f Hz failed\n", setup.sampleRate);
+                return 1;
+            }
+            held.clear();
+            restarts++;
+        }
+
+        int32 n = static_cast<int32>(std::lround(std::exp(unit(rng) * logMaxBlock)));
+        n = std::clamp(n, (int32)1, kMaxStressBlock);
+        std::uniform_int_distribution<int32> pickOffset(0, n - 1);
+
+        if (unit(rng) < kBurstChance)
+        {
+            int burst = pickBurst(rng);
+            for (int i = 0; i < burst; i++)
+            {
+                int16 pitch = static_cast<int16>(pickPitch(rng));
+                host.noteOn(pitch, static_cast<float>(0.1 + 0.9 * unit(rng)), pickOffset(rng));
+                held.push_back(pitch);
+            }
+        }
+        if (!held.empty() && unit(rng) < kNoteOffChance)
+        {
+            size_t k = static_cast<size_t>(unit(rng) * (double)held.size());
+            host.noteOff(held[k], pickOffset(rng));
+            held.erase(held.begin() + (std::ptrdiff_t)k);
+        }
+        if (unit(rng) < kStormChance)
+            parameterStorm(host, rng, n);
+
+        auto start = std::chrono::steady_clock::now();
+        tresult result = host.process(n);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (result != kResultOk)
+        {
+            fprintf(stderr, "kawaii_stress: process() failed\n");
+            return 1;
+        }
+
+        double blockSeconds = n / setup.sampleRate;
+        blocks.push_back({ elapsed * 1e6, elapsed / blockSeconds, n });
+        audioSeconds += blockSeconds;
+
+        for (int32 ch = 0; ch < HeadlessHost::kNumChannels; ch++)
+        {
+            const float* out = host.output(ch);
+            for (int32 s = 0; s < n; s++)
+            {
+                if (!std::isfinite(out[s]))
+                {
+                    nonFiniteSamples++;
+                    if (firstNonFiniteBlock < 0)
+                        firstNonFiniteBlock = (int64)blocks.size() - 1;
+                }
+            }
+        }
+    }
+
+    host.stop();
+
+    std::vector<double> micros, loads;
+    micros.reserve(blocks.size());
+    loads.reserve(blocks.size());
+    for (const auto& b : blocks)
+    {
+        micros.push_back(b.micros);
+        loads.push_back(b.load);
+    }
+    auto worst = std::max_element(blocks.begin(), blocks.end(),
+                                  [](const BlockSample& a, const BlockSample& b) { return a.load < b.load; });
+
+    printf("kawaii_stress: %zu blocks, %.1f s of audio, %d re-activations, seed %u\n",
+           blocks.size(), audioSeconds, restarts, seed);
+    printf("  block time  p50 %9.1f us  p99 %9.1f us  p99.9 %9.1f us  max %9.1f us\n",
+           percentile(micros, 0.5), percentile(micros, 0.99), percentile(micros, 0.999), percentile(micros, 1.0));
+    printf("  load        p50 %9.3f     p99 %9.3f     p99.9 %9.3f     max %9.3f (block of %d)\n",
+           percentile(loads, 0.5), percentile(loads, 0.99), percentile(loads, 0.999),
+           worst->load, worst->numSamples);
+
+    bool failed = false;
+    if (nonFiniteSamples > 0)
+    {
+        printf("FAIL: %lld NaN/Inf output samples, first in block %lld\n",
+               (long long)nonFiniteSamples, (long long)firstNonFiniteBlock);
+        failed = true;
+    }
+    if (worst->load > maxLoad)
+    {
+        printf("FAIL: worst block load %.3f exceeds --max-load %.3f\n", worst->load, maxLoad);
+        failed = true;
+    }
+    if (!failed)
+        printf("PASS\n");
+    return failed ? 1 : 0;
+}
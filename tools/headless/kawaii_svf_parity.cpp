@@ -0,0 +1,192 @@
+/**
+ * kawaii_svf_parity — Native SVF kernels against sst-filters' CytomicSVF
+ *
+ * Usage:
+ *   kawaii_svf_parity [--sample-rate 48000] [--threshold -50]
+ *
+ * For every filter type the voice runs on a native kernel
+ * (nativeSvfModeFor), filters the same noise through SvfKernel and through
+ * an sfpp::Filter set up the way KawaiiVoice sets up its library path:
+ * coefficients per kFilterBlockSize sub-block, cutoff in note units,
+ * all 4 SIMD lanes active, lane 0 read. Cases are a few fixed
+ * cutoff/resonance pairs plus a cutoff sweep, so the sub-block
+ * interpolation is covered as well.
+ *
+ * Reports the error energy relative to the library output, in dB. A case
+ * fails when that is above --threshold. If the phase-inverted kernel output
+ * would pass, that is reported too, since a flipped output tap is the
+ * likeliest cause. Exit status is the number of failures (capped at 125).
+ */
+
+#include "params/KawaiiFilterTypes.h"
+#include "processor/KawaiiFilterKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace Steinberg::Vst::Kawaii;
+
+namespace {
+
+static constexpr int kBlock = 32;            // KawaiiVoice's kFilterBlockSize
+static constexpr double kSeconds = 1.0;
+
+struct Case
+{
+    const char* name;
+    double fromHz;        // cutoff at the start …
+    double toHz;          // … and at the end (exponential sweep)
+    double reso;
+};
+
+static constexpr Case kCases[] = {
+    { "200Hz res0",       200.0,   200.0,  0.0 },
+    { "1kHz res0.5",     1000.0,  1000.0,  0.5 },
+    { "5kHz res0.9",     5000.0,  5000.0,  0.9 },
+    { "sweep res0.7",      40.0, 16000.0,  0.7 },
+};
+
+double cutoffAt(const Case& c, double t)
+{
+    return c.fromHz * std::pow(c.toHz / c.fromHz, t);
+}
+
+// KawaiiVoice::prepareFilterBlock's library branch
+void libraryCoefficients(sfpp::Filter& filter, double cutoffHz, double reso)
+{
+    float noteVal = static_cast<float>(12.0 * std::log2(std::max(cutoffHz, 1.0) / 440.0));
+    float r = static_cast<float>(std::clamp(reso, 0.0, 1.0));
+    for (int v = 0; v < 4; v++)
+        filter.makeCoefficients(v, noteVal, r);
+    filter.prepareBlock();
+}
+
+void renderLibrary(const FilterTypeEntry& entry, const Case& c, double sr,
+                   const std::vector<float>& in, std::vector<float>& out)
+{
+    sfpp::Filter filter;
+    filter.setFilterModel(entry.model);
+    filter.setModelConfiguration(sfpp::ModelConfig(entry.passband));
+    filter.prepareInstance();
+    filter.setSampleRateAndBlockSize(sr, kBlock);
+
+    // Settle the coefficients on the first target, as SvfKernel's first
+    // setTarget does
+    libraryCoefficients(filter, c.fromHz, c.reso);
+    filter.concludeBlock();
+
+    const int n = static_cast<int>(in.size());
+    out.resize(in.size());
+    for (int pos = 0; pos < n; pos += kBlock)
+    {
+        libraryCoefficients(filter, cutoffAt(c, static_cast<double>(pos) / n), c.reso);
+        for (int i = pos; i < std::min(pos + kBlock, n); i++)
+            out[(size_t)i] = filter.processMonoSample(in[(size_t)i]);
+        filter.concludeBlock();
+    }
+}
+
+template <SvfMode M>
+void renderNativeMode(const Case& c, double sr, const std::vector<float>& in, std::vector<float>& out)
+{
+    SvfKernel svf;
+    out = in;
+    const int n = static_cast<int>(in.size());
+    for (int pos = 0; pos < n; pos += kBlock)
+    {
+        svf.setTarget(cutoffAt(c, static_cast<double>(pos) / n), c.reso, sr, kBlock);
+        svf.template process<M>(out.data() + pos, std::min(kBlock, n - pos));
+        svf.conclude();
+    }
+}
+
+void renderNative(SvfMode mode, const Case& c, double sr, const std::vector<float>& in, std::vector<float>& out)
+{
+    switch (mode)
+    {
+        case SvfMode::LP:      renderNativeMode<SvfMode::LP>(c, sr, in, out);      break;
+        case SvfMode::HP:      renderNativeMode<SvfMode::HP>(c, sr, in, out);      break;
+        case SvfMode::BP:      renderNativeMode<SvfMode::BP>(c, sr, in, out);      break;
+        case SvfMode::Notch:   renderNativeMode<SvfMode::Notch>(c, sr, in, out);   break;
+        case SvfMode::Peak:    renderNativeMode<SvfMode::Peak>(c, sr, in, out);    break;
+        case SvfMode::Allpass: renderNativeMode<SvfMode::Allpass>(c, sr, in, out); break;
+    }
+}
+
+// Energy of (native·sign − library) relative to the library's, in dB
+double errorDb(const std::vector<float>& native, const std::vector<float>& library, float sign)
+{
+    double err = 0.0, ref = 0.0;
+    for (size_t i = 0; i < library.size(); i++)
+    {
+        double d = static_cast<double>(sign * native[i]) - library[i];
+        err += d * d;
+        ref += static_cast<double>(library[i]) * library[i];
+    }
+    if (!std::isfinite(err))
+        return HUGE_VAL;
+    return 10.0 * std::log10(std::max(err, 1e-30) / std::max(ref, 1e-30));
+}
+
+void usage()
+{
+    fprintf(stderr, "usage: kawaii_svf_parity [--sample-rate 48000] [--threshold -50]\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    double sr = 48000.0;
+    double threshold = -50.0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        auto takes = [&](const char* name) { return strcmp(a, name) == 0 && v && ++i; };
+
+        if (takes("--sample-rate"))    sr = atof(v);
+        else if (takes("--threshold")) threshold = atof(v);
+        else { usage(); return 2; }
+    }
+
+    // Same white noise for every case
+    std::vector<float> noise(static_cast<size_t>(kSeconds * sr));
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    for (auto& s : noise)
+        s = dist(rng);
+
+    int failures = 0, run = 0;
+    std::vector<float> native, library;
+    for (const auto& entry : getFilterTypes())
+    {
+        SvfMode mode;
+        if (!nativeSvfModeFor(entry.model, entry.passband, mode))
+            continue;
+
+        for (const auto& c : kCases)
+        {
+            run++;
+            renderNative(mode, c, sr, noise, native);
+            renderLibrary(entry, c, sr, noise, library);
+
+            double db = errorDb(native, library, 1.0f);
+            bool ok = db <= threshold;
+            printf("%s %-12s %-14s error %7.1f dB", ok ? "PASS" : "FAIL", entry.name, c.name, db);
+            if (!ok && errorDb(native, library, -1.0f) <= threshold)
+                printf("  (phase-inverted output would pass)");
+            printf("\n");
+            failures += ok ? 0 : 1;
+        }
+    }
+
+    printf("kawaii_svf_parity: %d/%d cases within %.1f dB\n", run - failures, run, threshold);
+    return std::min(failures, 125);
+}